@@ -0,0 +1,239 @@
+#include "bufferPool.hpp"
+#include <iostream>
+
+using namespace std;
+
+BufferPool::BufferPool(const int p_memorySize, const size_t p_pageSize)
+    : memorySize(p_memorySize), pageSize(p_pageSize), frames(p_memorySize), data(p_memorySize * p_pageSize),
+      pageFaults(0), interrupts(0), diskWrites(0) {}
+
+void BufferPool::unpin(const int frame) {
+    if (frames[frame].pinCount.fetch_sub(1) <= 0) {
+        frames[frame].pinCount.fetch_add(1);
+        cerr << "Unpin of a frame which isn't pinned: " << frame << endl;
+    }
+}
+
+bool BufferPool::get(const PageNumber pageNumber, const int dirty) {
+    bool hit = false;
+    const int frame = pin(pageNumber, &hit);
+    if (frame < 0) { return false; }
+    if (dirty == 1) { markDirty(frame); }
+    unpin(frame);
+    return hit;
+}
+
+PerformanceReport BufferPool::getReport() {
+    PerformanceReport performance;
+    performance.reset();
+    performance.algorithmName = algorithmName;
+    performance.memorySize = memorySize;
+    performance.pageFaults = pageFaults.load();
+    performance.interrupts = interrupts.load();
+    performance.diskWrites = diskWrites.load();
+    return performance;
+}
+
+void BufferPool::Load(const int frame, const PageNumber pageNumber) {
+    ++pageFaults;  // Page fault occurs when the page is not found in memory.
+    ++interrupts;  // An interrupt is generated when a page fault occurs.
+
+    Frame &f = frames[frame];
+    f.pageNumber = pageNumber;
+    f.ref.store(1, memory_order_relaxed);
+    f.dirty.store(0, memory_order_relaxed);
+    f.pinCount.store(1);
+    if (loader) { loader(pageNumber, getData(frame)); }
+}
+
+void BufferPool::WriteBack(const int frame) {
+    Frame &f = frames[frame];
+    if (f.dirty.load(memory_order_relaxed) == 1) { // Write back into the disk.
+        ++diskWrites;
+        ++interrupts;
+        f.dirty.store(0, memory_order_relaxed);
+        if (writer) { writer(f.pageNumber, getData(frame)); }
+    }
+}
+
+ClockBufferPool::ClockBufferPool(const int p_memorySize, const int p_shards, const size_t p_pageSize)
+    : BufferPool(p_memorySize, p_pageSize) {
+    algorithmName = "Clock Pool";
+    // Every shard needs at least one frame.
+    const int count = max(1, min(p_shards, p_memorySize));
+    for (int i = 0; i < count; ++i) {
+        shards.emplace_back(new Shard);
+        shards[i]->begin = (int64_t)p_memorySize * i / count;
+        shards[i]->size = (int64_t)p_memorySize * (i + 1) / count - shards[i]->begin;
+    }
+}
+
+int ClockBufferPool::pin(const PageNumber pageNumber, bool *hit) {
+    Shard &shard = *shards[hash<PageNumber>()(pageNumber) % shards.size()];
+    {
+        shared_lock<shared_mutex> lock(shard.lock);
+        auto it = shard.table.find(pageNumber);
+        if (it != shard.table.end()) {
+            // The page is found in memory. Set its reference bit to 1.
+            Frame &f = frames[it->second];
+            f.pinCount.fetch_add(1);
+            f.ref.store(1, memory_order_relaxed);
+            if (hit) { *hit = true; }
+            return it->second;
+        }
+    }
+
+    unique_lock<shared_mutex> lock(shard.lock);
+    if (hit) { *hit = false; }
+    auto it = shard.table.find(pageNumber);
+    if (it != shard.table.end()) { // Another thread faulted it in meanwhile
+        Frame &f = frames[it->second];
+        f.pinCount.fetch_add(1);
+        f.ref.store(1, memory_order_relaxed);
+        return it->second;
+    }
+
+    int frame;
+    if (shard.used < shard.size) {
+        frame = shard.begin + shard.used++;
+    } else {
+        frame = FindVictim(shard);
+        if (frame < 0) { return -1; }
+        shard.table.erase(frames[frame].pageNumber);
+        WriteBack(frame);
+    }
+    Load(frame, pageNumber);
+    shard.table[pageNumber] = frame;
+    return frame;
+}
+
+int ClockBufferPool::FindVictim(Shard &shard) {
+    // Two sweeps clear every reference bit, so a frame which isn't pinned is found by then.
+    for (int i = 0; i < 2 * shard.size; ++i) {
+        const int frame = shard.begin + shard.hand;
+        shard.hand = (shard.hand + 1) % shard.size;
+
+        Frame &f = frames[frame];
+        if (f.pinCount.load() > 0) { continue; }
+        if (f.ref.load(memory_order_relaxed) == 1) {  // If the reference bit is 1, give it a second chance.
+            f.ref.store(0, memory_order_relaxed);
+            continue;
+        }
+        return frame;
+    }
+    return -1;
+}
+
+void ClockBufferPool::flush() {
+    for (auto &shard : shards) {
+        unique_lock<shared_mutex> lock(shard->lock);
+        for (int i = 0; i < shard->used; ++i) { WriteBack(shard->begin + i); }
+    }
+}
+
+// Every thread records its hits into its own stripe.
+static atomic<int> nextStripe(0);
+static thread_local int threadStripe = nextStripe++;
+
+LruBufferPool::LruBufferPool(const int p_memorySize, const int p_stripes, const size_t p_batchSize, const size_t p_pageSize)
+    : BufferPool(p_memorySize, p_pageSize), position(p_memorySize), used(0), batchSize(max<size_t>(1, p_batchSize)) {
+    algorithmName = "LRU Pool";
+    for (int i = 0; i < max(1, p_stripes); ++i) { stripes.emplace_back(new Stripe); }
+}
+
+int LruBufferPool::pin(const PageNumber pageNumber, bool *hit) {
+    {
+        shared_lock<shared_mutex> shared(lock);
+        auto it = table.find(pageNumber);
+        if (it != table.end()) {
+            const int frame = it->second;
+            frames[frame].pinCount.fetch_add(1);
+            shared.unlock();
+
+            if (hit) { *hit = true; }
+            Record(frame, pageNumber);
+            return frame;
+        }
+    }
+
+    unique_lock<shared_mutex> exclusive(lock);
+    if (hit) { *hit = false; }
+    DrainAll(); // The list must be up to date to find the least recently used frame
+    auto it = table.find(pageNumber);
+    if (it != table.end()) { // Another thread faulted it in meanwhile
+        const int frame = it->second;
+        frames[frame].pinCount.fetch_add(1);
+        Apply({{frame, pageNumber}});
+        return frame;
+    }
+
+    int frame = -1;
+    if (used < memorySize) {
+        frame = used++;
+    } else {
+        // Choose and Remove a victim page from the back of the list.
+        for (auto victim = order.rbegin(); victim != order.rend(); ++victim) {
+            if (frames[*victim].pinCount.load() == 0) { frame = *victim; break; }
+        }
+        if (frame < 0) { return -1; }
+        order.erase(position[frame]);
+        table.erase(frames[frame].pageNumber);
+        WriteBack(frame);
+    }
+
+    // Add a new page into the front of the list.
+    Load(frame, pageNumber);
+    order.push_front(frame);
+    ++interrupts;
+    position[frame] = order.begin();
+    table[pageNumber] = frame;
+    return frame;
+}
+
+void LruBufferPool::Record(const int frame, const PageNumber pageNumber) {
+    Stripe &stripe = *stripes[threadStripe % stripes.size()];
+    vector<pair<int, PageNumber>> batch;
+    {
+        lock_guard<mutex> guard(stripe.lock);
+        stripe.accesses.push_back({frame, pageNumber});
+        if (stripe.accesses.size() < batchSize) { return; }
+        batch.swap(stripe.accesses);
+    }
+
+    unique_lock<shared_mutex> exclusive(lock);
+    Apply(batch);
+}
+
+void LruBufferPool::Apply(const vector<pair<int, PageNumber>> &accesses) {
+    for (const auto &access : accesses) {
+        // The frame may hold another page by now, then the access is stale.
+        if (frames[access.first].pageNumber != access.second) { continue; }
+        // Move it to the front of the list.
+        order.splice(order.begin(), order, position[access.first]);
+        ++interrupts;
+    }
+}
+
+void LruBufferPool::DrainAll() {
+    for (auto &stripe : stripes) {
+        vector<pair<int, PageNumber>> batch;
+        {
+            lock_guard<mutex> guard(stripe->lock);
+            batch.swap(stripe->accesses);
+        }
+        Apply(batch);
+    }
+}
+
+void LruBufferPool::flush() {
+    unique_lock<shared_mutex> exclusive(lock);
+    for (int frame = 0; frame < used; ++frame) { WriteBack(frame); }
+}
+
+PerformanceReport LruBufferPool::getReport() {
+    {
+        unique_lock<shared_mutex> exclusive(lock);
+        DrainAll();
+    }
+    return BufferPool::getReport();
+}
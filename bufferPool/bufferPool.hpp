@@ -0,0 +1,116 @@
+#ifndef __bufferPool__
+#define __bufferPool__
+
+#include "../performanceReport/performanceReport.hpp"
+#include "../pageReplacement/pageReplacement.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+using namespace std;
+
+// Thread-safe buffer pools built from the replacement policies, for embedding in a service.
+// pin() makes a page resident and keeps it in its frame until the matching unpin().
+// Faults, interrupts and disk writes are counted the same way as PageReplacement.
+class BufferPool {
+public:
+    BufferPool(const int p_memorySize, const size_t p_pageSize = 0);
+    virtual ~BufferPool() {}
+
+    // Fill a frame on a fault, and save a dirty frame when it's evicted or flushed.
+    void setLoader(const function<void(PageNumber, char *)> p_loader) { loader = p_loader; }
+    void setWriter(const function<void(PageNumber, const char *)> p_writer) { writer = p_writer; }
+
+    // Returns the frame of the page, or -1 if every frame is pinned. *hit tells if the page was resident.
+    virtual int pin(const PageNumber pageNumber, bool *hit = nullptr) = 0;
+    void unpin(const int frame);
+    void markDirty(const int frame) { frames[frame].dirty.store(1, memory_order_relaxed); }
+    char *getData(const int frame) { return pageSize == 0 ? nullptr : &data[frame * pageSize]; } // pageSize bytes of the frame
+    bool get(const PageNumber pageNumber, const int dirty = 0); // One reference: pin, markDirty, unpin. Returns true on a hit.
+    virtual void flush() = 0; // Write every dirty frame back
+    virtual PerformanceReport getReport();
+
+protected:
+    typedef struct Frame {
+        PageNumber pageNumber = 0;
+        atomic<int> pinCount{0};
+        atomic<int> ref{0}; // reference bit
+        atomic<int> dirty{0}; // dirty bit
+    } Frame;
+
+    string algorithmName;
+    int memorySize;
+    size_t pageSize;
+    vector<Frame> frames;
+    vector<char> data;
+    atomic<int64_t> pageFaults, interrupts, diskWrites;
+    function<void(PageNumber, char *)> loader;
+    function<void(PageNumber, const char *)> writer;
+
+    void Load(const int frame, const PageNumber pageNumber); // Fault the page into the frame, pinned
+    void WriteBack(const int frame);
+};
+
+// CLOCK (Second Chance) split into shards by page number, each with its own clock hand.
+// A hit takes only the shared lock of its shard and sets the reference bit atomically;
+// a fault takes the shard exclusively. With one shard it evicts exactly like PageReplacement::SecondChance().
+class ClockBufferPool : public BufferPool {
+public:
+    ClockBufferPool(const int p_memorySize, const int p_shards = 16, const size_t p_pageSize = 0);
+    ~ClockBufferPool() {}
+
+    int pin(const PageNumber pageNumber, bool *hit = nullptr) override;
+    void flush() override;
+
+private:
+    typedef struct Shard {
+        shared_mutex lock;
+        unordered_map<PageNumber, int> table; // <page number, frame>
+        int begin, size; // The shard owns the frames [begin, begin + size)
+        int used = 0;
+        int hand = 0; // Next frame to check, relative to begin
+    } Shard;
+
+    vector<unique_ptr<Shard>> shards;
+
+    int FindVictim(Shard &shard); // Sweep the clock hand, skipping pinned frames
+};
+
+// LRU approximation: a hit records the access in a per-thread stripe buffer instead of touching the list,
+// and a full buffer is applied to the list in one batch under the exclusive lock.
+// Every buffer is drained before an eviction, so with one thread it evicts exactly like PageReplacement::LRU().
+class LruBufferPool : public BufferPool {
+public:
+    LruBufferPool(const int p_memorySize, const int p_stripes = 16, const size_t p_batchSize = 64, const size_t p_pageSize = 0);
+    ~LruBufferPool() {}
+
+    int pin(const PageNumber pageNumber, bool *hit = nullptr) override;
+    void flush() override;
+    PerformanceReport getReport() override;
+
+private:
+    typedef struct Stripe {
+        mutex lock;
+        vector<pair<int, PageNumber>> accesses; // <frame, page number> of the recorded hits
+    } Stripe;
+
+    shared_mutex lock;
+    unordered_map<PageNumber, int> table; // <page number, frame>
+    list<int> order; // Frames from the most to the least recently used
+    vector<list<int>::iterator> position; // Position of each frame in order
+    int used;
+    size_t batchSize;
+    vector<unique_ptr<Stripe>> stripes;
+
+    void Record(const int frame, const PageNumber pageNumber);
+    void Apply(const vector<pair<int, PageNumber>> &accesses); // Needs the exclusive lock
+    void DrainAll(); // Needs the exclusive lock
+};
+
+#endif // __bufferPool__
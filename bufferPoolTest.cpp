@@ -0,0 +1,168 @@
+#include "bufferPool/bufferPool.hpp"
+#include "pageReplacement/pageReplacement.hpp"
+#include "performanceReport/performanceReport.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstring>
+
+using namespace std;
+
+// Buffer pool tests. With one thread, LruBufferPool must report the same page faults, interrupts and disk writes as
+// PageReplacement::LRU(), and a one-shard ClockBufferPool the same as PageReplacement::SecondChance().
+// Under concurrent pins, a pinned frame must keep its page, and pin() may return -1 only when every frame is pinned.
+// ./bufferPoolTest [iterations] [seed]
+
+static bool Same(const PerformanceReport &expected, const PerformanceReport &actual) {
+    return expected.pageFaults == actual.pageFaults && expected.interrupts == actual.interrupts && expected.diskWrites == actual.diskWrites;
+}
+
+// Replay the reference string with one thread and compare the counts with the simulator.
+static bool CheckSequential(BufferPool &pool, const PerformanceReport &expected, const vector<Reference> &pages, const string &description) {
+    for (const auto &p : pages) { pool.get(p.pageNumber, p.dirty); }
+    const PerformanceReport actual = pool.getReport();
+    if (Same(expected, actual)) { return true; }
+
+    cout << "Mismatch: " << description << ", " << pages.size() << " references" << endl;
+    cout << "  simulator: "; PerformanceReport(expected).printReport(2);
+    cout << "  pool:      "; PerformanceReport(actual).printReport(2);
+    return false;
+}
+
+// Pin every frame with distinct pages: one more page must get -1 until a frame is unpinned.
+static bool CheckAllPinned(BufferPool &pool, const int memorySize, const string &description) {
+    vector<int> pinned;
+    for (int i = 0; i < memorySize; ++i) {
+        const int frame = pool.pin(i);
+        if (frame < 0) {
+            cout << description << ": pin() returned -1 with " << memorySize - i << " frames free" << endl;
+            return false;
+        }
+        pinned.push_back(frame);
+    }
+    bool ok = true;
+    if (pool.pin(memorySize) != -1) {
+        cout << description << ": pin() found a frame while every frame is pinned" << endl;
+        ok = false;
+    }
+    pool.unpin(pinned[0]);
+    const int frame = pool.pin(memorySize);
+    if (frame != pinned[0]) {
+        cout << description << ": pin() didn't reuse the only unpinned frame" << endl;
+        ok = false;
+    }
+    if (frame >= 0) { pool.unpin(frame); }
+    for (size_t i = 1; i < pinned.size(); ++i) { pool.unpin(pinned[i]); }
+    return ok;
+}
+
+// Every thread holds up to `holds` pins at once, on pages of a small range so the pool keeps evicting.
+// The loader stamps the page number into its frame: if a pinned frame were evicted, the stamp would change under the pin.
+// With threads * holds no more than the frames, some frame is always unpinned, so pin() must never return -1.
+static bool CheckConcurrent(BufferPool &pool, const int memorySize, const int threads, const int holds, const int pinsPerThread,
+                            const unsigned int seed, const string &description) {
+    pool.setLoader([](PageNumber pageNumber, char *data) { memcpy(data, &pageNumber, sizeof(pageNumber)); });
+    atomic<int> badStamps(0), badWrites(0), refused(0);
+    pool.setWriter([&](PageNumber pageNumber, const char *data) {
+        PageNumber stamp;
+        memcpy(&stamp, data, sizeof(stamp));
+        if (stamp != pageNumber) { ++badWrites; }
+    });
+
+    auto worker = [&](const unsigned int threadSeed) {
+        mt19937 generator(threadSeed);
+        uniform_int_distribution<PageNumber> page(0, 3 * memorySize);
+        vector<pair<int, PageNumber>> held; // <frame, page number>
+        for (int i = 0; i < pinsPerThread; ++i) {
+            if ((int)held.size() == holds || (!held.empty() && generator() % 2 == 0)) {
+                // Release the oldest pin after checking its frame still holds the page.
+                const auto pin = held.front();
+                held.erase(held.begin());
+                PageNumber stamp;
+                memcpy(&stamp, pool.getData(pin.first), sizeof(stamp));
+                if (stamp != pin.second) { ++badStamps; }
+                pool.unpin(pin.first);
+                continue;
+            }
+            const PageNumber pageNumber = page(generator);
+            const int frame = pool.pin(pageNumber);
+            if (frame < 0) { ++refused; continue; }
+            if (generator() % 4 == 0) { pool.markDirty(frame); }
+            held.push_back({frame, pageNumber});
+        }
+        for (const auto &pin : held) { pool.unpin(pin.first); }
+    };
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) { workers.emplace_back(worker, seed + t); }
+    for (auto &w : workers) { w.join(); }
+    pool.flush();
+
+    if (badStamps == 0 && badWrites == 0 && (refused == 0 || threads * holds > memorySize)) { return true; }
+    cout << description << ": " << badStamps << " pinned frames lost their page, " << badWrites << " frames written back with another page, "
+         << refused << " pins refused" << endl;
+    return false;
+}
+
+int main(int argc, const char * argv[]) {
+    const int iterations = argc > 1 ? stoi(argv[1]) : 200;
+    const unsigned int seed = argc > 2 ? stoul(argv[2]) : 2023;
+    mt19937 generator(seed);
+    auto random = [&](const int low, const int high) { return uniform_int_distribution<int>(low, high)(generator); };
+
+    int failures = 0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        // A random reference string, with bursts and loops so hits, evictions and write-backs all occur
+        vector<Reference> pages;
+        const int memorySize = random(1, 16);
+        const int range = random(1, 3 * memorySize + 2);
+        const int length = random(1, 2000);
+        while ((int)pages.size() < length) {
+            const int kind = random(0, 2);
+            if (kind == 0) {
+                pages.push_back({random(0, range), random(0, 1)});
+            } else if (kind == 1) {
+                const int page = random(0, range), burst = random(1, 5);
+                for (int i = 0; i < burst; ++i) { pages.push_back({page, random(0, 3) == 0}); }
+            } else {
+                for (int i = 0; i <= memorySize; ++i) { pages.push_back({i, random(0, 1)}); }
+            }
+        }
+
+        PageReplacement pageReplacement(memorySize, "");
+        pageReplacement.setReferences(pages, "buffer_pool_test");
+        const string frames = to_string(memorySize) + " frames, iteration " + to_string(iteration);
+
+        LruBufferPool lru(memorySize, random(1, 4), random(1, 100));
+        if (!CheckSequential(lru, pageReplacement.LRU(), pages, "LruBufferPool vs LRU, " + frames)) { ++failures; }
+        ClockBufferPool clock(memorySize, 1);
+        if (!CheckSequential(clock, pageReplacement.SecondChance(), pages, "ClockBufferPool vs Second Chance, " + frames)) { ++failures; }
+    }
+
+    for (const int memorySize : {1, 5, 16}) {
+        LruBufferPool lru(memorySize);
+        if (!CheckAllPinned(lru, memorySize, "LruBufferPool, " + to_string(memorySize) + " frames")) { ++failures; }
+        ClockBufferPool clock(memorySize, 1);
+        if (!CheckAllPinned(clock, memorySize, "ClockBufferPool, " + to_string(memorySize) + " frames")) { ++failures; }
+    }
+
+    // (frames, shards, threads, pins held per thread): some frame stays unpinned, or every frame may be pinned.
+    const vector<vector<int>> configurations = {{8, 1, 4, 2}, {16, 2, 4, 2}, {32, 4, 4, 2}, {4, 1, 4, 3}, {16, 4, 8, 4}};
+    for (const auto &c : configurations) {
+        const string setting = to_string(c[0]) + " frames, " + to_string(c[2]) + " threads holding " + to_string(c[3]) + " pins";
+        // A page lives in one shard, so every shard must have room for all the pins held.
+        const int shardFrames = c[0] / c[1];
+        LruBufferPool lru(c[0], 4, 8, sizeof(PageNumber));
+        if (!CheckConcurrent(lru, c[0], c[2], c[3], 100000, generator(), "LruBufferPool, " + setting)) { ++failures; }
+        ClockBufferPool clock(c[0], c[1], sizeof(PageNumber));
+        if (!CheckConcurrent(clock, shardFrames, c[2], c[3], 100000, generator(), "ClockBufferPool (" + to_string(c[1]) + " shards), " + setting)) {
+            ++failures;
+        }
+    }
+
+    cout << iterations << " reference strings and " << configurations.size() << " concurrent settings: " << failures << " failures" << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -3,13 +3,16 @@
 
 import matplotlib.pyplot as plt
 import pandas as pd
+import numpy as np
 import os
 
-title = ["algorithmName", "referenceStringName", "memorySize", "pageFaults", "interrupts", "diskWrites"]
+title = ["algorithmName", "referenceStringName", "memorySize", "parameter", "pageFaults", "interrupts", "diskWrites"]
 algorithmName = ["FIFO", "ARB", "ESC", "LRU-LFU"]
 performance = ["Page faults", "Interrupts", "Disk writes"]
-dataName = ["Random data", "Locality data", "Exponential random data"]
+# Titles of the reference strings of experiment.txt; other traces are titled by their file names.
+dataTitle = {"uniform": "Random data", "locality": "Locality data", "exponential": "Exponential random data", "normal": "Normal random data"}
 mark = ["o", "v", "s", "*", "D"]
+lineStyle = ['--', ':', '-', ':', '-.']
 
 font = {'family' : 'normal',
         'weight' : 'bold',
@@ -23,54 +26,75 @@ if not isExist:
     os.makedirs(imgPath)
     print("create img directory")
 
+def readCsv(name):
+    # Every run of ./main appends its rows, so keep the latest row of each (reference string, frames, parameter).
+    data = pd.read_csv(name + ".csv")
+    if title[3] not in data:
+        data[title[3]] = 0 # Written before the parameter column
+    return data.drop_duplicates(subset=[title[1], title[2], title[3]], keep='last').sort_values(title[2])
+
+def label(name, parameter):
+    return name if parameter == 0 else name + " (" + "%g" % parameter + ")"
+
+def dataName(referenceStringName):
+    for key in dataTitle:
+        if os.path.basename(referenceStringName).startswith(key):
+            return dataTitle[key]
+    return os.path.basename(referenceStringName)
+
+def savePlot(fileName):
+    plt.legend()
+    plt.grid(True)
+    fig = plt.gcf()
+    fig.set_size_inches(16, 12)
+    fig.savefig("img/" + fileName + '.jpg', dpi=100)
+    plt.clf()
+
+algorithms = [name for name in algorithmName if os.path.exists(name + ".csv")]
+datas = {name: readCsv(name) for name in algorithms}
+# Reference strings in the order they were simulated
+referenceStrings = list(dict.fromkeys(name for data in datas.values() for name in data[title[1]]))
+
 # 1. The plots between performance and frames each algorithm.
-for i in range(4) : # of algorithm
-    data = pd.read_csv(algorithmName[i] + ".csv")
-    k = 0
-    for j in range(0, 15, 5): # (0, # of needed row, # of memorySize)
-    
-        plt.plot(data[title[2]][j:j+5], data[title[3]][j:j+5], label=performance[0], linewidth=5, linestyle='--', marker=mark[0], markersize=15)
-        plt.plot(data[title[2]][j:j+5], data[title[4]][j:j+5], label=performance[1], linewidth=5, linestyle=':', marker=mark[1], markersize=15)
-        plt.plot(data[title[2]][j:j+5], data[title[5]][j:j+5], label=performance[2], linewidth=5, alpha=0.5, marker=mark[2], markersize=15)
-        
-        plt.title(algorithmName[i] + " : " + dataName[k], fontsize=36, fontweight='bold')
-        plt.xlabel("The number of frames", fontsize=24, fontweight='bold')
-        plt.ylabel("Values", fontsize=24, fontweight='bold')
-        plt.xlim(20, 100)
-        plt.ylim(0)
-        plt.legend()
-        plt.grid(True)
-        
-        fig = plt.gcf()
-        fig.set_size_inches(16, 12)
-        k += 1
-        fig.savefig("img/" + algorithmName[i] + str(k) + '.jpg', dpi=100)
-        plt.clf()
+for name in algorithms:
+    data = datas[name]
+    for k, referenceString in enumerate(referenceStrings):
+        parameters = data[data[title[1]] == referenceString].groupby(title[3], sort=False)
+        for parameter, rows in parameters:
+            for i in range(3):
+                plt.plot(rows[title[2]], rows[title[i + 4]], label=performance[i], linewidth=5, linestyle=lineStyle[i], marker=mark[i], markersize=15, alpha=0.5 if i == 2 else 1)
+
+            plt.title(label(name, parameter) + " : " + dataName(referenceString), fontsize=36, fontweight='bold')
+            plt.xlabel("The number of frames", fontsize=24, fontweight='bold')
+            plt.ylabel("Values", fontsize=24, fontweight='bold')
+            plt.xlim(rows[title[2]].min(), rows[title[2]].max())
+            plt.ylim(0)
+            savePlot(name + str(k + 1) + ("" if len(parameters) == 1 else "_" + "%g" % parameter))
 
 # 2. The plots between performance and frames each data.
-FIFO = pd.read_csv(algorithmName[0] + ".csv")
-ARB = pd.read_csv(algorithmName[1] + ".csv")
-ESC = pd.read_csv(algorithmName[2] + ".csv")
-LRULFU = pd.read_csv(algorithmName[3] + ".csv")
-
-
-for i in range(3, 6, 1) : 
-    for j in range(0, 15, 5) :
-        plt.plot(FIFO[title[2]][j:j+5],    FIFO[title[i]][j:j+5], label=algorithmName[0], linewidth=5, linestyle='--', marker=mark[0], markersize=15)
-        plt.plot(ARB[title[2]][j:j+5],     ARB[title[i]][j:j+5], label=algorithmName[1], linewidth=5, linestyle=':', marker=mark[1], markersize=15)
-        plt.plot(ESC[title[2]][j:j+5],     ESC[title[i]][j:j+5], label=algorithmName[2], linewidth=5, linestyle='-', marker=mark[2], markersize=15, alpha=0.5)
-        plt.plot(LRULFU[title[2]][j:j+5],  LRULFU[title[i]][j:j+5], label=algorithmName[3], linewidth=5, linestyle=':', marker=mark[3], markersize=15, alpha=0.5)
-        
-        plt.title(dataName[int(j/5)], fontsize=36, fontweight='bold')
+for i in range(4, 7, 1):
+    for referenceString in referenceStrings:
+        lines = [(name, parameter, rows) for name in algorithms
+                 for parameter, rows in datas[name][datas[name][title[1]] == referenceString].groupby(title[3], sort=False)]
+        for j, (name, parameter, rows) in enumerate(lines):
+            plt.plot(rows[title[2]], rows[title[i]], label=label(name, parameter), linewidth=5, linestyle=lineStyle[j % len(lineStyle)], marker=mark[j % len(mark)], markersize=15, alpha=1 if j < 2 else 0.5)
+
+        plt.title(dataName(referenceString), fontsize=36, fontweight='bold')
+        plt.xlabel("The number of frames", fontsize=24, fontweight='bold')
+        plt.ylabel("The number of " + performance[i-4].lower(), fontsize=24, fontweight='bold')
+        savePlot(dataName(referenceString) + str(i-2))
+
+# 3. The time per simulation (mean and standard deviation over the repetitions) each data, see experiment.txt.
+if os.path.exists("experiment_timing.csv"):
+    timing = pd.read_csv("experiment_timing.csv")
+    timing = timing.drop_duplicates(subset=["algorithmName", "referenceStringName", "memorySize", "parameter"], keep='last')
+    for referenceString, rows in timing.groupby("referenceStringName", sort=False):
+        for j, ((name, parameter), cell) in enumerate(rows.groupby(["algorithmName", "parameter"], sort=False)):
+            cell = cell.sort_values("memorySize")
+            plt.errorbar(cell["memorySize"], cell["meanSeconds"] * 1e3, yerr=np.sqrt(cell["varianceSeconds"]) * 1e3, label=label(name, parameter), linewidth=3, linestyle=lineStyle[j % len(lineStyle)], marker=mark[j % len(mark)], markersize=10, capsize=6)
+
+        plt.title(dataName(referenceString), fontsize=36, fontweight='bold')
         plt.xlabel("The number of frames", fontsize=24, fontweight='bold')
-        plt.ylabel("The number of " + performance[i-3].lower(), fontsize=24, fontweight='bold')
-        plt.xlim(20, 100)
-        #plt.ylim(0)
-        plt.legend()
-        plt.grid(True)
-        
-        fig = plt.gcf()
-        fig.set_size_inches(16, 12)
-        fig.savefig("img/" + dataName[int(j/5)] + str(i-1) + '.jpg', dpi=100)
-        plt.clf()
-        # print(str(int(j/5+1)) + " " +str(i-1))
\ No newline at end of file
+        plt.ylabel("Time per simulation (ms)", fontsize=24, fontweight='bold')
+        plt.yscale('log')
+        savePlot(dataName(referenceString) + " time")
@@ -0,0 +1,335 @@
+#include "pageReplacement/pageReplacement.hpp"
+#include "oraclePageReplacement/oraclePageReplacement.hpp"
+#include "referenceString/referenceString.hpp"
+#include "runLengthTrace/runLengthTrace.hpp"
+#include "performanceReport/performanceReport.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+#include <map>
+#include <limits>
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+using namespace std;
+
+// Differential fuzzing: PageReplacement must report the same page faults, interrupts and disk writes as the
+// straightforward implementations in OraclePageReplacement, on random and adversarial reference strings.
+// A mismatch is shrunk to a minimal reference string and saved as fuzz_reproducer_<n>.txt, which
+// ./main simulate <file> <algorithm> <frames> -p <parameter> replays.
+// Every policy with checkpoints must resume to the counts of an uninterrupted simulation.
+// The write-aware optimal is checked against its lower bound and, on tiny reference strings, an exhaustive search.
+// ./differentialFuzz [iterations] [seed]
+
+typedef struct FuzzCase {
+    string algorithm;
+    int memorySize;
+    int parameter; // ARB interval
+    int loader; // How the engine reads the reference string: 0 setReferences, 1 text file, 2 run-length file
+    vector<Reference> pages;
+} FuzzCase;
+
+static const vector<string> algorithms = {"FIFO", "Second Chance", "ESC", "LRU", "LRU-LFU", "ARB", "Optimal"};
+static const vector<string> resumable = {"FIFO", "Second Chance", "ESC", "LRU", "LRU-LFU", "ARB", "Optimal", "Sampled LRU", "Sampled LFU"};
+
+static PerformanceReport RunOracle(const FuzzCase &c) {
+    OraclePageReplacement oracle(c.memorySize, c.pages);
+    if (c.algorithm == "FIFO") { return oracle.FIFO(); }
+    if (c.algorithm == "Second Chance") { return oracle.SecondChance(); }
+    if (c.algorithm == "ESC") { return oracle.EnhancedSecondChance(); }
+    if (c.algorithm == "LRU") { return oracle.LRU(); }
+    if (c.algorithm == "LRU-LFU") { return oracle.LRU_LFU(); }
+    if (c.algorithm == "ARB") { return oracle.ARB(c.parameter); }
+    return oracle.Optimal();
+}
+
+static PerformanceReport RunEngine(const FuzzCase &c) {
+    string fileName;
+    if (c.loader == 1) {
+        fileName = "fuzz_reference_string.txt";
+        ofstream file(fileName);
+        for (const auto &p : c.pages) { file << p.pageNumber << " " << p.dirty << "\n"; }
+    } else if (c.loader == 2) {
+        fileName = "fuzz_reference_string.rlt";
+        RunLengthWriter writer(fileName);
+        for (const auto &p : c.pages) { writer.Append(p.pageNumber, p.dirty); }
+        writer.Close();
+    }
+
+    PageReplacement pageReplacement(c.memorySize, fileName);
+    if (c.loader == 0) { pageReplacement.setReferences(c.pages, "fuzz"); }
+    return pageReplacement.Simulate(c.algorithm, c.parameter);
+}
+
+static bool Same(const PerformanceReport &a, const PerformanceReport &b) {
+    return a.pageFaults == b.pageFaults && a.interrupts == b.interrupts && a.diskWrites == b.diskWrites;
+}
+
+static bool Fails(const FuzzCase &c) { return !Same(RunOracle(c), RunEngine(c)); }
+
+// Delta debugging: drop chunks of references from halves down to single ones, then clear dirty bits,
+// use fewer frames and renumber the pages, as long as the mismatch remains.
+static FuzzCase Shrink(FuzzCase c) {
+    for (size_t chunk = max<size_t>(1, c.pages.size() / 2); ; chunk /= 2) {
+        for (size_t begin = 0; begin < c.pages.size(); ) {
+            FuzzCase smaller = c;
+            smaller.pages.erase(smaller.pages.begin() + begin, smaller.pages.begin() + min(begin + chunk, c.pages.size()));
+            if (Fails(smaller)) { c = smaller; } else { begin += chunk; }
+        }
+        if (chunk <= 1) { break; }
+    }
+    for (size_t i = 0; i < c.pages.size(); ++i) {
+        if (c.pages[i].dirty == 0) { continue; }
+        FuzzCase clean = c;
+        clean.pages[i].dirty = 0;
+        if (Fails(clean)) { c = clean; }
+    }
+    while (c.memorySize > 1) {
+        FuzzCase fewer = c;
+        --fewer.memorySize;
+        if (!Fails(fewer)) { break; }
+        c = fewer;
+    }
+
+    // Page numbers 1, 2, 3, ... in order of first reference
+    FuzzCase renumbered = c;
+    unordered_map<PageNumber, PageNumber> number;
+    for (auto &p : renumbered.pages) {
+        auto it = number.emplace(p.pageNumber, number.size() + 1).first;
+        p.pageNumber = it->second;
+    }
+    return Fails(renumbered) ? renumbered : c;
+}
+
+// A simulation stopped at a run, checkpointed and resumed must report the same counts as an uninterrupted one.
+// Resuming the checkpoint with other frames must simulate nothing and leave the checkpoint as it is.
+static bool CheckResume(const FuzzCase &c, const unsigned int draw) {
+    const string checkpoint = "fuzz_checkpoint.state";
+    PageReplacement whole(c.memorySize, ""), first(c.memorySize, ""), second(c.memorySize, "");
+    whole.setReferences(c.pages, "fuzz");
+    first.setReferences(c.pages, "fuzz");
+    second.setReferences(c.pages, "fuzz");
+
+    PerformanceReport expected = whole.Simulate(c.algorithm, c.parameter);
+    // setSegment(0, 0) would simulate the whole trace, so the first engine stops after 1 to all runs.
+    // Only an empty reference string checkpoints at run 0.
+    const size_t split = whole.getRunCount() == 0 ? 0 : 1 + draw % whole.getRunCount();
+    first.setSegment(0, split);
+    first.setCheckpoint(checkpoint);
+    first.Simulate(c.algorithm, c.parameter);
+    second.resume(checkpoint);
+    PerformanceReport actual = second.Simulate(c.algorithm, c.parameter);
+
+    auto content = [&]() { ifstream file(checkpoint); return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>()); };
+    const string saved = content();
+    PageReplacement other(c.memorySize + 1, "");
+    other.setReferences(c.pages, "fuzz");
+    other.resume(checkpoint);
+    other.setCheckpoint(checkpoint, 1);
+    streambuf *errors = cerr.rdbuf(nullptr); // The rejected checkpoint is expected
+    other.Simulate(c.algorithm, c.parameter);
+    cerr.rdbuf(errors);
+    if (!other.hasFailed() || content() != saved) {
+        cout << "Resume of another configuration: " << c.algorithm << " started cold or changed the checkpoint" << endl;
+        return false;
+    }
+    if (Same(expected, actual)) { return true; }
+
+    cout << "Resume mismatch: " << c.algorithm << ", frames " << c.memorySize << ", parameter " << c.parameter
+         << ", split at run " << split << " of " << whole.getRunCount() << endl;
+    cout << "  uninterrupted: "; expected.printReport(2);
+    cout << "  resumed: "; actual.printReport(2);
+    return false;
+}
+
+// Minimum of page faults + alpha x disk writes over every eviction choice, by exhaustive search
+static double MinimumWriteAwareCost(const vector<Reference> &pages, const int memorySize, const double alpha) {
+    map<vector<pair<PageNumber, int>>, double> costs = {{{}, 0.0}}; // <sorted (page, dirty) in memory, cost>
+    for (const auto &p : pages) {
+        map<vector<pair<PageNumber, int>>, double> nextCosts;
+        auto relax = [&](vector<pair<PageNumber, int>> memory, const double cost) {
+            sort(memory.begin(), memory.end());
+            auto it = nextCosts.find(memory);
+            if (it == nextCosts.end() || cost < it->second) { nextCosts[memory] = cost; }
+        };
+        for (const auto &c : costs) {
+            vector<pair<PageNumber, int>> memory = c.first;
+            auto it = find_if(memory.begin(), memory.end(), [&](const pair<PageNumber, int> &m) { return m.first == p.pageNumber; });
+            if (it != memory.end()) {
+                it->second |= p.dirty;
+                relax(memory, c.second);
+            } else if (memory.size() < memorySize) {
+                memory.push_back({p.pageNumber, p.dirty});
+                relax(memory, c.second + 1);
+            } else {
+                for (size_t victim = 0; victim < memory.size(); ++victim) {
+                    vector<pair<PageNumber, int>> replaced = memory;
+                    replaced[victim] = {p.pageNumber, p.dirty};
+                    relax(replaced, c.second + 1 + alpha * memory[victim].second);
+                }
+            }
+        }
+        costs.swap(nextCosts);
+    }
+
+    double minimum = numeric_limits<double>::infinity();
+    for (const auto &c : costs) { minimum = min(minimum, c.second); }
+    return minimum;
+}
+
+// The write-aware optimal schedule can't cost less than the exhaustive minimum, which can't cost less than
+// the lower bound. The exhaustive minimum is skipped for long reference strings.
+static bool CheckWriteAware(const vector<Reference> &pages, const int memorySize, const double alpha, const bool exhaustive) {
+    PageReplacement pageReplacement(memorySize, "");
+    pageReplacement.setReferences(pages, "fuzz");
+    const PerformanceReport schedule = pageReplacement.WriteAwareOptimal(alpha);
+    const double cost = schedule.pageFaults + alpha * schedule.diskWrites;
+    const double bound = pageReplacement.WriteAwareLowerBound(alpha);
+    const double minimum = exhaustive ? MinimumWriteAwareCost(pages, memorySize, alpha) : cost;
+    const double epsilon = 1e-6;
+    if (bound <= minimum + epsilon && minimum <= cost + epsilon) { return true; }
+
+    cout << "Write-aware mismatch: frames " << memorySize << ", alpha " << alpha << ", lower bound " << bound;
+    if (exhaustive) { cout << ", minimum " << minimum; }
+    cout << ", schedule " << cost << ", " << pages.size() << " references:";
+    for (const auto &p : pages) { cout << " " << p.pageNumber << ":" << p.dirty; }
+    cout << endl;
+    return false;
+}
+
+// A run of more than 2^31 references must keep its LRU-LFU count, also through a checkpoint:
+// with two frames, page 3 evicts page 2 (one reference) rather than page 1.
+static bool CheckLongRun() {
+    const vector<Run> runs = {{1, 0, 3000000000LL}, {2, 0, 1}, {3, 0, 1}, {1, 0, 1}};
+    const string checkpoint = "fuzz_checkpoint.state";
+    PageReplacement whole(2, ""), first(2, ""), second(2, "");
+    whole.setRuns(runs, "long run");
+    first.setRuns(runs, "long run");
+    second.setRuns(runs, "long run");
+
+    const PerformanceReport expected = whole.LRU_LFU();
+    first.setSegment(0, 1);
+    first.setCheckpoint(checkpoint);
+    first.LRU_LFU();
+    second.resume(checkpoint);
+    const PerformanceReport actual = second.LRU_LFU();
+    if (expected.pageFaults == 3 && Same(expected, actual)) { return true; }
+
+    cout << "LRU-LFU count of a long run: 3 page faults expected" << endl;
+    cout << "  uninterrupted: "; PerformanceReport(expected).printReport(2);
+    cout << "  resumed: "; PerformanceReport(actual).printReport(2);
+    return false;
+}
+
+// Read a generated reference string back
+static vector<Reference> ReadReferences(const string &fileName) {
+    vector<Reference> pages;
+    ifstream file(fileName);
+    PageNumber pageNumber;
+    int dirty;
+    while (file >> pageNumber >> dirty) { pages.push_back({pageNumber, dirty}); }
+    return pages;
+}
+
+int main(int argc, const char * argv[]) {
+    const int iterations = argc > 1 ? stoi(argv[1]) : 500;
+    const unsigned int seed = argc > 2 ? stoul(argv[2]) : 2023;
+    mt19937 generator(seed);
+    auto random = [&](const int low, const int high) { return uniform_int_distribution<int>(low, high)(generator); };
+
+    int failures = 0;
+    unordered_set<string> failed; // Report the first mismatch of each algorithm only
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        // A random or adversarial reference string with a small number of frames
+        vector<Reference> pages;
+        int memorySize = random(1, 8);
+        const int kind = iteration % 11;
+        const int length = random(kind == 1 ? 20 : 1, 300);
+        const string generatedFile = "fuzz_generated_reference_string.txt";
+        if (kind < 4) {
+            const int referenceSize = random(2, 40);
+            const double dirtyRate = vector<double>{0.0, 0.3, 0.5, 1.0}[random(0, 3)];
+            ReferenceStringGenerator referenceString(length, referenceSize, dirtyRate, generator());
+            if (kind == 0) { referenceString.UniformRandom(random(1, 20), generatedFile); }
+            // The locality subsets hold length / 30 to length / 20 references, so at least one for 20 references.
+            if (kind == 1) { referenceString.LocalityUniformRandom(random(1, 20), 1.0 / 30.0, 1.0 / 20.0, generatedFile); }
+            if (kind == 2) { referenceString.NormalRandom(referenceSize / 2 + 1, referenceSize / 6 + 1, generatedFile); }
+            if (kind == 3) { referenceString.ExponentialRandom(3.0 / referenceSize, generatedFile); }
+            pages = ReadReferences(generatedFile);
+        } else if (kind == 4) {
+            // A single page
+            for (int i = 0; i < length; ++i) { pages.push_back({7, random(0, 1)}); }
+        } else if (kind == 5) {
+            // Every reference is a write
+            for (int i = 0; i < length; ++i) { pages.push_back({random(1, 12), 1}); }
+        } else if (kind == 6) {
+            // As many frames as pages, or more
+            const int distinct = random(1, 10);
+            for (int i = 0; i < length; ++i) { pages.push_back({random(1, distinct), random(0, 1)}); }
+            memorySize = distinct + random(0, 2);
+        } else if (kind == 7) {
+            // A loop over one page more than the frames, the worst case of LRU and FIFO
+            for (int i = 0; i < length; ++i) { pages.push_back({i % (memorySize + 1), random(0, 1)}); }
+        } else if (kind == 8) {
+            // Bursts of back-to-back references to one page, with dirty bits inside the bursts
+            while (pages.size() < length) {
+                const int page = random(1, 10), burst = random(1, 6);
+                for (int i = 0; i < burst; ++i) { pages.push_back({page, random(0, 3) == 0}); }
+            }
+        } else if (kind == 9) {
+            // Sparse 64-bit page numbers, including sequential pages
+            const PageNumber base = PageNumber(random(1, 1 << 20)) << 32;
+            for (int i = 0; i < length; ++i) { pages.push_back({base + (random(0, 1) ? random(0, 15) : i % 9), random(0, 1)}); }
+        } else {
+            // An empty reference string, or a single reference
+            if (random(0, 1)) { pages.push_back({random(0, 3), random(0, 1)}); }
+        }
+
+        for (const auto &algorithm : algorithms) {
+            FuzzCase c = {algorithm, memorySize, random(1, 4), random(0, 2), pages};
+            if (!Fails(c)) { continue; }
+            ++failures;
+            if (!failed.insert(algorithm).second) { continue; }
+
+            const FuzzCase minimal = Shrink(c);
+            PerformanceReport expected = RunOracle(minimal), actual = RunEngine(minimal);
+            const string reproducer = "fuzz_reproducer_" + to_string(failed.size()) + ".txt";
+            ofstream file(reproducer);
+            for (const auto &p : minimal.pages) { file << p.pageNumber << " " << p.dirty << "\n"; }
+
+            cout << "Mismatch: " << algorithm << ", frames " << minimal.memorySize << ", parameter " << minimal.parameter
+                 << ", loader " << minimal.loader << ", iteration " << iteration << endl;
+            cout << "  oracle: "; expected.printReport(2);
+            cout << "  engine: "; actual.printReport(2);
+            cout << "  " << minimal.pages.size() << " references, saved in " << reproducer << ":";
+            for (const auto &p : minimal.pages) { cout << " " << p.pageNumber << ":" << p.dirty; }
+            cout << endl;
+        }
+
+        // Checkpoint and resume at a random run
+        for (const auto &algorithm : resumable) {
+            FuzzCase c = {algorithm, memorySize, random(1, 4), 0, pages};
+            if (!CheckResume(c, generator())) { ++failures; }
+        }
+
+        // The write-aware optimal on this reference string, and exhaustively on a tiny one
+        const double alpha = vector<double>{0.0, 0.5, 1.0, 1.5, 3.0}[random(0, 4)];
+        if (!CheckWriteAware(pages, memorySize, alpha, false)) { ++failures; }
+        vector<Reference> tiny(random(1, 12));
+        for (auto &p : tiny) { p = {random(1, 5), random(0, 1)}; }
+        if (!CheckWriteAware(tiny, random(1, 3), alpha, true)) { ++failures; }
+    }
+
+    if (!CheckLongRun()) { ++failures; }
+
+    for (const string file : {"fuzz_reference_string.txt", "fuzz_reference_string.rlt", "fuzz_generated_reference_string.txt",
+                              "fuzz_generated_reference_string.txt.meta", "fuzz_checkpoint.state"}) { remove(file.c_str()); }
+    cout << iterations << " reference strings x " << algorithms.size() << " algorithms, resumed checkpoints and the write-aware optimal: " << failures << " mismatches" << endl;
+    return failures == 0 ? 0 : 1;
+}
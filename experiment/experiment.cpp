@@ -0,0 +1,301 @@
+#include "experiment.hpp"
+#include "../referenceString/referenceString.hpp"
+#include "../traceImporter/traceImporter.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// A number, or a fraction such as 1/30
+static double ParseNumber(const string &text) {
+    const size_t slash = text.find('/');
+    if (slash == string::npos) { return stod(text); }
+    return stod(text.substr(0, slash)) / stod(text.substr(slash + 1));
+}
+
+Experiment::Experiment()
+    : dataSize(200000), referenceSize(1000), dirtyRate(0.5), seed(2023), repetitions(1), threads(1) {
+    SetDefaults();
+}
+
+void Experiment::SetDefaults() {
+    if (memorySizes.empty()) { memorySizes = {20, 40, 60, 80, 100}; }
+    if (policies.empty()) {
+        for (const auto &name : PageReplacement::getAlgorithmNames()) {
+            policies.push_back({name, {PageReplacement::getDefaultParameter(name)}});
+        }
+    }
+}
+
+bool Experiment::Load(const string &specFile) {
+    ifstream file(specFile);
+    if (!file) { cerr << "Experiment spec don't be opened: " << specFile << endl; return false; }
+
+    traces.clear();
+    memorySizes.clear();
+    policies.clear();
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        istringstream words(line);
+        string keyword, word;
+        if (!(words >> keyword)) { continue; }
+        vector<string> arguments;
+        while (words >> word) { arguments.push_back(word); }
+
+        try {
+            if (keyword == "generator") {
+                for (const auto &argument : arguments) {
+                    const size_t equal = argument.find('=');
+                    const string key = argument.substr(0, equal), value = equal == string::npos ? "" : argument.substr(equal + 1);
+                    if (key == "dataSize") { dataSize = stoi(value); }
+                    else if (key == "referenceSize") { referenceSize = stoi(value); }
+                    else if (key == "dirtyRate") { dirtyRate = ParseNumber(value); }
+                    else if (key == "seed") { seed = stoul(value); }
+                    else { throw invalid_argument(argument); }
+                }
+            } else if (keyword == "trace" && arguments.size() >= 2) {
+                TraceSpec trace = {arguments[0], arguments[1], {}};
+                for (size_t i = 2; i < arguments.size(); ++i) {
+                    const size_t equal = arguments[i].find('=');
+                    if (equal == string::npos) { throw invalid_argument(arguments[i]); }
+                    trace.options[arguments[i].substr(0, equal)] = arguments[i].substr(equal + 1);
+                }
+                traces.push_back(trace);
+            } else if (keyword == "frames") {
+                // <n> ... or <first>..<last> [step <n>], at least one frame
+                for (size_t i = 0; i < arguments.size(); ++i) {
+                    const size_t dots = arguments[i].find("..");
+                    if (dots == string::npos) {
+                        memorySizes.push_back(stoi(arguments[i]));
+                        if (memorySizes.back() < 1) { throw invalid_argument("frames " + arguments[i]); }
+                        continue;
+                    }
+                    const int first = stoi(arguments[i].substr(0, dots)), last = stoi(arguments[i].substr(dots + 2));
+                    if (first < 1) { throw invalid_argument("frames " + arguments[i]); }
+                    int step = 1;
+                    if (i + 2 < arguments.size() && arguments[i + 1] == "step") {
+                        step = stoi(arguments[i + 2]);
+                        i += 2;
+                    }
+                    if (step < 1) { throw invalid_argument("step " + to_string(step)); }
+                    for (int m = first; m <= last; m += step) { memorySizes.push_back(m); }
+                }
+            } else if (keyword == "policy" && !arguments.empty()) {
+                // <name> [parameter=<value>,<value>...]; a name may have spaces, e.g. "Second Chance"
+                PolicySpec policy;
+                for (const auto &argument : arguments) {
+                    if (argument.compare(0, 10, "parameter=") == 0) {
+                        istringstream values(argument.substr(10));
+                        string value;
+                        while (getline(values, value, ',')) { policy.parameters.push_back(ParseNumber(value)); }
+                    } else {
+                        policy.name += (policy.name.empty() ? "" : " ") + argument;
+                    }
+                }
+                if (policy.parameters.empty()) { policy.parameters.push_back(PageReplacement::getDefaultParameter(policy.name)); }
+                if (PageReplacement::getAlgorithmVersion(policy.name) == 0) { throw invalid_argument("unknown policy " + policy.name); }
+                for (const double parameter : policy.parameters) {
+                    if (!PageReplacement::isValidParameter(policy.name, parameter)) {
+                        throw invalid_argument("parameter " + FormatParameter(parameter) + " of " + policy.name);
+                    }
+                }
+                policies.push_back(policy);
+            } else if (keyword == "repetitions" && arguments.size() == 1) {
+                repetitions = max(1, stoi(arguments[0]));
+            } else if (keyword == "threads" && arguments.size() == 1) {
+                threads = max(1, stoi(arguments[0]));
+            } else {
+                throw invalid_argument(line);
+            }
+        } catch (const exception &e) {
+            cerr << specFile << ":" << lineNumber << ": invalid setting: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    SetDefaults();
+    return true;
+}
+
+bool Experiment::LoadTrace(const TraceSpec &trace, vector<LoadedTrace> &loaded) {
+    auto option = [&](const string &key, const string &fallback) {
+        auto it = trace.options.find(key);
+        return it == trace.options.end() ? fallback : it->second;
+    };
+
+    try {
+        // Files generated earlier with the same seed and parameters are reused.
+        ReferenceStringGenerator generator(dataSize, referenceSize, dirtyRate, seed);
+        if (trace.kind == "uniform") {
+            // Random: Arbitrarily pick [1, range] continuous numbers for each reference.
+            generator.UniformRandom(stoi(option("range", "20")), trace.name);
+        } else if (trace.kind == "locality") {
+            // Locality: Simulate function calls. Each function call may refer a subset of subsetA~subsetB string
+            generator.LocalityUniformRandom(stoi(option("range", "20")), ParseNumber(option("subsetA", "1/30")),
+                                            ParseNumber(option("subsetB", "1/20")), trace.name);
+        } else if (trace.kind == "normal") {
+            generator.NormalRandom(stoi(option("mean", to_string(referenceSize / 2))), stoi(option("sd", to_string(referenceSize / 20))), trace.name);
+        } else if (trace.kind == "exponential") {
+            generator.ExponentialRandom(ParseNumber(option("lambda", "1/" + to_string(referenceSize))), trace.name);
+        } else if (trace.kind == "lackey" || trace.kind == "binary") {
+            // pageSize=<bytes>[,<bytes>...]: every page size shares one pass over the trace.
+            vector<uint64_t> pageSizes;
+            istringstream sizes(option("pageSize", "4096"));
+            string size;
+            while (getline(sizes, size, ',')) { pageSizes.push_back(stoull(size)); }
+            TraceImporter importer;
+            auto referenceStrings = importer.LoadMultiple(trace.kind, option("source", ""), pageSizes);
+            if (referenceStrings.empty()) { return false; }
+            for (size_t i = 0; i < pageSizes.size(); ++i) {
+                const string name = pageSizes.size() == 1 ? trace.name : trace.name + "_" + to_string(pageSizes[i]);
+                loaded.push_back({name, pageSizes[i], PageReplacement(0, "")});
+                loaded.back().pageReplacement.setRuns(move(referenceStrings[i]), name);
+            }
+            return true;
+        } else if (trace.kind != "file") {
+            cerr << "Unknown trace kind: " << trace.kind << endl;
+            return false;
+        }
+    } catch (const exception &e) {
+        cerr << "Invalid option of the trace " << trace.name << ": " << e.what() << endl;
+        return false;
+    }
+
+    if (!fs::exists(trace.name)) { cerr << "Reference string don't be found: " << trace.name << endl; return false; }
+    loaded.push_back({trace.name, 0, PageReplacement(0, trace.name)});
+    return true;
+}
+
+bool Experiment::Run(ResultCache &cache) {
+    // Per-cell timing next to the CSV reports of the counts
+    fs::create_directory("../data");
+    ofstream timingFile("../data/experiment_timing.csv", ios::app);
+    if (timingFile.tellp() == 0) {
+        timingFile << "algorithmName,referenceStringName,memorySize,parameter,repetitions,meanSeconds,varianceSeconds" << endl;
+    }
+
+    bool loadedAll = true;
+    for (const auto &trace : traces) {
+        vector<LoadedTrace> loaded;
+        if (!LoadTrace(trace, loaded)) { loadedAll = false; continue; }
+        for (auto &referenceString : loaded) { RunCells(referenceString, cache, timingFile); }
+    }
+    return loadedAll;
+}
+
+void Experiment::RunCells(LoadedTrace &loaded, ResultCache &cache, ofstream &timingFile) {
+    typedef struct Cell {
+        string algorithm;
+        int memorySize;
+        double parameter;
+        PerformanceReport performance;
+        Timing timing;
+        bool cached;
+    } Cell;
+
+    PageReplacement &pageReplacement = loaded.pageReplacement;
+    const string &name = loaded.name;
+    cout << "The reference string file is: " << name << endl;
+    if (loaded.pageSize > 0) { cout << "The page size is: " << loaded.pageSize << endl; }
+    cout << "The size of data: " << pageReplacement.getFileSize() << endl;
+    if (loaded.pageSize > 0) {
+        // All pages touched by the trace
+        const size_t distinctPages = pageReplacement.getDistinctPages();
+        cout << "The number of different pages: " << distinctPages << " (" << distinctPages * loaded.pageSize << " bytes)" << endl;
+    }
+    cout << endl;
+
+    // Every cell of the trace; only those missing from the cache, or timed fewer times, are simulated.
+    // A result saved without timing is enough for a single repetition.
+    vector<Cell> cells;
+    vector<size_t> pending;
+    for (const int m : memorySizes) {
+        for (const auto &policy : policies) {
+            for (const double parameter : policy.parameters) {
+                Cell cell = {policy.name, m, parameter, PerformanceReport(), Timing(), false};
+                const int version = PageReplacement::getAlgorithmVersion(policy.name);
+                cell.cached = cache.find(pageReplacement.getTraceHash(), policy.name, version, m, parameter, cell.performance, &cell.timing)
+                    && (cell.timing.repetitions >= repetitions || repetitions == 1);
+                if (!cell.cached) { pending.push_back(cells.size()); }
+                cells.push_back(cell);
+            }
+        }
+    }
+
+    // Each thread simulates on its own engine; the copies share the runs of the trace.
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        PageReplacement engine = pageReplacement;
+        for (size_t i = next++; i < pending.size(); i = next++) {
+            Cell &cell = cells[pending[i]];
+            engine.setMemorySize(cell.memorySize);
+            vector<double> seconds;
+            for (int r = 0; r < repetitions; ++r) {
+                const auto start = chrono::steady_clock::now();
+                PerformanceReport performance = engine.Simulate(cell.algorithm, cell.parameter);
+                seconds.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+                if (r > 0 && (performance.pageFaults != cell.performance.pageFaults || performance.diskWrites != cell.performance.diskWrites)) {
+                    cerr << "Repetitions of " << cell.algorithm << " differ on " << name << endl;
+                }
+                cell.performance = performance;
+            }
+
+            cell.timing.repetitions = repetitions;
+            cell.timing.mean = 0;
+            for (const auto s : seconds) { cell.timing.mean += s / repetitions; }
+            cell.timing.variance = 0;
+            for (const auto s : seconds) { cell.timing.variance += (s - cell.timing.mean) * (s - cell.timing.mean); }
+            cell.timing.variance = repetitions > 1 ? cell.timing.variance / (repetitions - 1) : 0;
+
+            // Saved right away, so an interrupted sweep keeps every finished cell.
+            cell.performance.algorithmName = cell.algorithm;
+            cell.performance.memorySize = cell.memorySize;
+            cache.insert(pageReplacement.getTraceHash(), PageReplacement::getAlgorithmVersion(cell.algorithm),
+                         cell.memorySize, cell.parameter, cell.performance, cell.timing);
+        }
+    };
+    vector<thread> workers;
+    for (int t = 1; t < min<size_t>(threads, pending.size()); ++t) { workers.emplace_back(worker); }
+    worker();
+    for (auto &w : workers) { w.join(); }
+
+    // An imported trace also reports sizes in bytes, every page holding pageSize bytes.
+    cout << "Algorithm              frames  parameter  page faults  interrupts  disk writes   mean ms    stddev ms"
+         << (loaded.pageSize > 0 ? "     memory bytes  write-back bytes" : "") << endl;
+    for (auto &cell : cells) {
+        cell.performance.algorithmName = cell.algorithm;
+        cell.performance.memorySize = cell.memorySize;
+        cout << left << setw(22) << cell.algorithm << right << setw(8) << cell.memorySize << setw(11) << FormatParameter(cell.parameter)
+             << setw(13) << cell.performance.pageFaults << setw(12) << cell.performance.interrupts << setw(13) << cell.performance.diskWrites
+             << fixed << setprecision(3);
+        if (cell.timing.repetitions > 0) {
+            cout << setw(10) << cell.timing.mean * 1e3 << setw(13) << sqrt(cell.timing.variance) * 1e3;
+        } else {
+            cout << setw(10) << "-" << setw(13) << "-";
+        }
+        if (loaded.pageSize > 0) {
+            cout << setw(17) << loaded.pageSize * cell.memorySize << setw(18) << loaded.pageSize * cell.performance.diskWrites;
+        }
+        cout << (cell.cached ? "  (cached)" : "") << endl;
+        cout.unsetf(ios::fixed);
+
+        cell.performance.writeCsvReport(name, cell.memorySize, cell.parameter);
+        if (cell.timing.repetitions == 0) { continue; }
+        timingFile << cell.algorithm << "," << name << "," << cell.memorySize << "," << FormatParameter(cell.parameter) << ","
+                   << cell.timing.repetitions << "," << cell.timing.mean << "," << cell.timing.variance << endl;
+    }
+    cout << endl;
+}
@@ -0,0 +1,65 @@
+#ifndef __experiment__
+#define __experiment__
+
+#include "../performanceReport/performanceReport.hpp"
+#include "../pageReplacement/pageReplacement.hpp"
+#include "../resultCache/resultCache.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <cstdint>
+
+using namespace std;
+
+typedef struct TraceSpec { // A reference string of the experiment
+    string name; // File name, or the name of an imported trace
+    string kind; // uniform, locality, normal, exponential (generated), file, lackey or binary (imported)
+    unordered_map<string, string> options; // key=value settings of the generator or the importer
+} TraceSpec;
+
+typedef struct PolicySpec { // An algorithm and the parameters to run it with
+    string name; // Report name, as accepted by PageReplacement::Simulate()
+    vector<double> parameters;
+} PolicySpec;
+
+// Declarative experiment: every (trace, frames, policy, parameter) cell of a spec file.
+// Each trace is loaded once, the cells missing from the result cache are simulated on a pool of threads,
+// and every cell reports its counts and its time per simulation (mean and variance over the repetitions).
+// See experiment.txt for the spec format. Without a spec, every algorithm runs with its default parameter
+// on 20, 40, 60, 80 and 100 frames.
+class Experiment {
+public:
+    Experiment();
+    ~Experiment() {}
+
+    bool Load(const string &specFile);
+    void setTraces(const vector<TraceSpec> &p_traces) { traces = p_traces; }
+    bool Run(ResultCache &cache); // False if a trace couldn't be loaded; the other traces still run
+
+private:
+    // Generator settings
+    int dataSize;
+    int referenceSize;
+    double dirtyRate;
+    unsigned int seed;
+
+    vector<TraceSpec> traces;
+    vector<int> memorySizes; // Numbers of frames
+    vector<PolicySpec> policies;
+    int repetitions;
+    int threads;
+
+    typedef struct LoadedTrace { // A reference string ready to simulate
+        string name;
+        uint64_t pageSize; // 0 unless the trace is imported
+        PageReplacement pageReplacement;
+    } LoadedTrace;
+
+    void SetDefaults();
+    // A trace imported with several page sizes gives one reference string per size, named <name>_<page size>.
+    bool LoadTrace(const TraceSpec &trace, vector<LoadedTrace> &loaded);
+    void RunCells(LoadedTrace &loaded, ResultCache &cache, ofstream &timingFile);
+};
+
+#endif // __experiment__
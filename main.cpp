@@ -1,81 +1,114 @@
-#include "referenceString/referenceString.hpp"
 #include "performanceReport/performanceReport.hpp"
 #include "pageReplacement/pageReplacement.hpp"
+#include "resultCache/resultCache.hpp"
+#include "experiment/experiment.hpp"
 #include <iostream>
+#include <string>
+#include <functional>
+#include <iomanip>
+#include <chrono>
+#include <filesystem>
 
 using namespace std;
+namespace fs = std::filesystem;
 
 int main(int argc, const char * argv[]) {
-    // init parameters of three different test reference strings.
-    const int dataSize = 200000; // Number of memory references: At least 200,000 times
-    const int referenceSize = 1000; // page Reference string: 1~1,000
-    const double dirtyRate = 0.5;
-    const double subsetRateA = 1.0 / 30.0;
-    const double subsetRateB = 1.0 / 20.0;
-    int referenceRange = 20;
-    double setSize = 20;
-    double lambda = 1.0 / referenceSize; // 期望平均值與參考字串的大小 (Ref. size) 相關
-
-    vector<int> memorySize = {20, 40, 60, 80, 100}; // Number of frames in the physical memory
-    vector<string> fileName = {"uniform_reference_string.txt", "locality_reference_string.txt", "exponential_reference_string.txt", "normal_reference_string.txt"}; // 
-    vector<string> algorithmName = {"FIFO", "SecondChance", "ESC", "LRU", "LRU-LFU", "ARB", "Optimal"}; //  
-
-    // generate three test reference strings:
-    ReferenceStringGenerator generator(dataSize, referenceSize, dirtyRate);
-    // Random: Arbitrarily pick [1, 20] continuous numbers for each reference.
-    generator.UniformRandom(referenceRange, "uniform_reference_string.txt");
-    // Locality: Simulate function calls. Each function call may refer a subset of 1/30~1/20 string
-    generator.LocalityUniformRandom(referenceRange, subsetRateA, subsetRateB, "locality_reference_string.txt");
-    
-    generator.NormalRandom(referenceSize / 2, referenceSize / setSize, "normal_reference_string.txt");
-    generator.ExponentialRandom(lambda, "exponential_reference_string.txt");
-
-    // init performance report and page replacement objects;
-    PerformanceReport performance;
-    PageReplacement pageReplacement(memorySize[0], fileName[0]);
-    
-    // Execute different algoritms on each tests with different number of frames.
-    for (int i = 0; i < fileName.size(); ++i) {
-        pageReplacement.setFileName(fileName[i]);
-        cout << "The reference string file is: " << fileName[i] << endl;
-        cout << "The size of data: " << pageReplacement.getFileSize() << endl;
+    if (argc >= 5 && string(argv[1]) == "simulate") {
+        // Run one algorithm with checkpoints, or continue it from a checkpoint:
+        // ./main simulate <reference string> <algorithm> <frames> [-p parameter] [-c <checkpoint file> <every N runs>]
+        //                 [-r <checkpoint file>] [-s <first run> <end run>]
+        if (stoi(argv[4]) < 1) { cerr << "The number of frames must be at least 1: " << argv[4] << endl; return 1; }
+        PageReplacement pageReplacement(stoi(argv[4]), argv[2]);
+        double parameter = PageReplacement::getDefaultParameter(argv[3]);
+        for (int i = 5; i < argc; ++i) {
+            const string option = argv[i];
+            if (option == "-p" && i + 1 < argc) {
+                parameter = stod(argv[++i]);
+                if (!PageReplacement::isValidParameter(argv[3], parameter)) {
+                    cerr << "Invalid parameter of " << argv[3] << ": " << argv[i] << endl;
+                    return 1;
+                }
+            } else if (option == "-c" && i + 2 < argc) {
+                pageReplacement.setCheckpoint(argv[i + 1], stoull(argv[i + 2]));
+                i += 2;
+            } else if (option == "-r" && i + 1 < argc) {
+                pageReplacement.resume(argv[++i]);
+            } else if (option == "-s" && i + 2 < argc) {
+                pageReplacement.setSegment(stoull(argv[i + 1]), stoull(argv[i + 2]));
+                i += 2;
+            } else {
+                cerr << "Unknown option: " << option << endl;
+                return 1;
+            }
+        }
+        cout << "The reference string file is: " << argv[2] << endl;
+        cout << "The size of data: " << pageReplacement.getFileSize() << " (" << pageReplacement.getRunCount() << " runs)" << endl;
         cout << endl;
 
-        for (int j = 0; j < memorySize.size(); ++j) {
-
-            cout << "The number of frames: " << memorySize[j] << endl;
-            pageReplacement.setMemorySize(memorySize[j]);
-            cout << endl;
-            
-            performance = pageReplacement.FIFO();
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
-            
-            performance = pageReplacement.SecondChance();
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
-
-            performance = pageReplacement.EnhancedSecondChance();
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
+        PerformanceReport performance = pageReplacement.Simulate(argv[3], parameter);
+        if (pageReplacement.hasFailed()) { return 1; } // The checkpoint to resume is kept as it is
+        performance.printReport();
+        if (string(argv[3]) == "Write-Aware Optimal") {
+            const double alpha = parameter >= 0 ? parameter : 1.0;
+            cout << "Cost (faults + " << FormatParameter(alpha) << " x writes): " << fixed << setprecision(1)
+                 << performance.pageFaults + alpha * performance.diskWrites
+                 << ", lower bound: " << pageReplacement.WriteAwareLowerBound(alpha) << endl;
+        }
+        return 0;
+    }
 
-            performance = pageReplacement.LRU();
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
+    if (argc >= 4 && string(argv[1]) == "sampled") {
+        // Compare the sampled policies with the exact ones as the number of samples K varies:
+        // ./main sampled <reference string> <frames> [K ...]
+        if (stoi(argv[3]) < 1) { cerr << "The number of frames must be at least 1: " << argv[3] << endl; return 1; }
+        PageReplacement pageReplacement(stoi(argv[3]), argv[2]);
+        vector<int> samples = {1, 3, 5, 10, 16};
+        if (argc > 4) { samples.clear(); }
+        for (int i = 4; i < argc; ++i) {
+            if (!PageReplacement::isValidParameter("Sampled LRU", stod(argv[i]))) { cerr << "Invalid number of samples: " << argv[i] << endl; return 1; }
+            samples.push_back(stoi(argv[i]));
+        }
 
-            performance = pageReplacement.LRU_LFU();
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
+        cout << "The reference string file is: " << argv[2] << " (" << pageReplacement.getFileSize() << " references)" << endl;
+        cout << "The number of frames: " << argv[3] << endl;
+        cout << "Algorithm          K  page faults  fault rate  disk writes  M refs/s" << endl;
+        auto report = [&](const string &algorithm, const int k, const function<PerformanceReport()> &simulate) {
+            const auto start = chrono::steady_clock::now();
+            const PerformanceReport performance = simulate();
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << left << setw(16) << algorithm << right << setw(3) << k << setw(13) << performance.pageFaults
+                 << fixed << setprecision(4) << setw(12) << (double)performance.pageFaults / pageReplacement.getFileSize()
+                 << setw(13) << performance.diskWrites << setprecision(2) << setw(10) << pageReplacement.getFileSize() / seconds / 1e6 << endl;
+        };
+        report("LRU", 0, [&]() { return pageReplacement.LRU(); });
+        report("LRU-LFU", 0, [&]() { return pageReplacement.LRU_LFU(); });
+        for (const int k : samples) {
+            report("Sampled LRU", k, [&]() { return pageReplacement.SampledLRU(k); });
+            report("Sampled LFU", k, [&]() { return pageReplacement.SampledLFU(k); });
+        }
+        return 0;
+    }
 
-            performance = pageReplacement.ARB(setSize);
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
+    // The traces, frames and policies of the experiment: ./main [spec file], see experiment.txt.
+    // An imported trace runs with the frames and policies of ../experiment.txt, or with every algorithm when it's missing.
+    Experiment experiment;
+    const string specFile = argc == 2 ? argv[1] : "../experiment.txt";
+    if ((argc <= 2 || fs::exists(specFile)) && !experiment.Load(specFile)) { return 1; }
 
-            performance = pageReplacement.Optimal();
-            performance.printReport();
-            performance.writeCsvReport(fileName[i], memorySize[j]);
+    if (argc >= 3) {
+        // Import a real memory-access trace instead of the synthetic ones, evaluating several page sizes with one pass:
+        // ./main <lackey|binary> <trace file> [page size in bytes, default 4096] [page size] ...
+        const string format = argv[1];
+        if (format != "lackey" && format != "binary") {
+            cerr << "Unknown trace format: " << format << " (lackey or binary)" << endl;
+            return 1;
         }
+        string pageSizes = argc >= 4 ? argv[3] : "4096";
+        for (int i = 4; i < argc; ++i) { pageSizes += string(",") + argv[i]; }
+        experiment.setTraces({{"imported", format, {{"source", argv[2]}, {"pageSize", pageSizes}}}});
     }
 
-    return 0;
+    // Results of earlier runs, keyed by trace content and configuration
+    ResultCache cache("result_cache.txt");
+    return experiment.Run(cache) ? 0 : 1;
 }
\ No newline at end of file
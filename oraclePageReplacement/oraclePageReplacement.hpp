@@ -0,0 +1,40 @@
+#ifndef __oraclePageReplacement__
+#define __oraclePageReplacement__
+
+#include "../performanceReport/performanceReport.hpp"
+#include "../pageReplacement/pageReplacement.hpp"
+#include <string>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Reference implementations of the PageReplacement algorithms, see differentialFuzz.cpp.
+// Every optimized algorithm must report the same page faults, interrupts and disk writes as its oracle.
+class OraclePageReplacement {
+public:
+    OraclePageReplacement(const int p_memorySize, const vector<Reference> &p_pages);
+    ~OraclePageReplacement() {}
+
+    // Algorithms
+    PerformanceReport FIFO();
+    PerformanceReport ARB(const int interval = 1);
+    PerformanceReport SecondChance();
+    PerformanceReport EnhancedSecondChance();
+    PerformanceReport Optimal();
+    PerformanceReport LRU();
+    PerformanceReport LRU_LFU();
+
+private:
+    PerformanceReport performance;
+    int memorySize;
+    vector<Reference> pages;
+
+    // Member functions
+    int OptimalPredict(const int index, const vector<PageNumber> &memory); // Find a victim for optimal
+    int FindMinRefBit(const vector<PageNumber> &memory, unordered_map<PageNumber, Bits> &memortBits); // Find a victim for ARB
+    void UpdateARB(const vector<PageNumber> &memory, unordered_map<PageNumber, Bits> &memortBits, unordered_set<PageNumber> &memoryHit); // For ARB
+};
+
+#endif // __oraclePageReplacement__
@@ -1,13 +1,20 @@
 #include "../performanceReport/performanceReport.hpp"
 #include "pageReplacement.hpp"
+#include "../runLengthTrace/runLengthTrace.hpp"
+#include "../resultCache/resultCache.hpp"
 #include <fstream>
 #include <iostream>
 #include <queue>
 #include <list>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <cstdio>
 
 using namespace std;
 
-void printQueue(queue<int> q) {
+void printQueue(queue<PageNumber> q) {
     if (q.size() != 0) {
         do {
             cout << q.front() << " "; q.pop();
@@ -16,46 +23,271 @@ void printQueue(queue<int> q) {
     cout << endl;
 }
 
-void printVector(const vector<int> &vec) {
+void printVector(const vector<PageNumber> &vec) {
     for (const auto v : vec) { cout << v << " "; }
     cout << endl;
 }
 
 PageReplacement::PageReplacement(const int p_memorySize, const string p_fileName) 
-    : memorySize(p_memorySize) {
+    : memorySize(p_memorySize), pages(make_shared<const vector<Run>>()), references(0), traceHash(0), parameter(0), simulationEnd(0), failed(false),
+    checkpointInterval(0), segmented(false), segmentBegin(0), segmentEnd(0) {
         setFileName(p_fileName);
     }
 
+void AppendRun(vector<Run> &runs, const Run &run) {
+    if (!runs.empty() && runs.back().pageNumber == run.pageNumber) {
+        runs.back().count += run.count;
+        runs.back().dirty |= run.dirty;
+    } else {
+        runs.push_back(run);
+    }
+}
+
 void PageReplacement::setFileName(const string p_fileName) {
     if (fileName != p_fileName) {
         fileName = p_fileName;
-        
-        // Open a file and check if it is opened.
-        ifstream file(fileName);
-        if (!file) { cerr << "File don't be opened." << endl; }
-        
-        // Store all content of the file.
-        int pageNumber, dirty;
-        pages.clear();
-        // Column 0 is a page number and column 1 is a dirty bit.
-        while (file >> pageNumber >> dirty) { pages.push_back({pageNumber, dirty}); }
-        file.close();
+        vector<Run> runs;
+
+        if (IsRunLengthTrace(fileName)) {
+            // A run-length compressed reference string is decoded straight into runs.
+            ReadRunLengthTrace(fileName, runs);
+        } else {
+            // Open a file and check if it is opened.
+            ifstream file(fileName);
+            if (!file) { cerr << "File don't be opened." << endl; }
+            
+            // Store all content of the file.
+            PageNumber pageNumber;
+            int dirty;
+            // Column 0 is a page number and column 1 is a dirty bit.
+            while (file >> pageNumber >> dirty) { AppendRun(runs, {pageNumber, dirty, 1}); }
+            file.close();
+        }
+        SetPages(move(runs));
     }
 }
 
+void PageReplacement::setReferences(vector<Reference> p_pages, const string p_name) {
+    fileName = p_name;
+    vector<Run> runs;
+    for (const auto &p : p_pages) { AppendRun(runs, {p.pageNumber, p.dirty, 1}); }
+    SetPages(move(runs));
+}
+
+void PageReplacement::setRuns(vector<Run> p_runs, const string p_name) {
+    fileName = p_name;
+    vector<Run> runs;
+    for (const auto &p : p_runs) { AppendRun(runs, p); } // Runs of one page may arrive split
+    SetPages(move(runs));
+}
+
+void PageReplacement::SetPages(vector<Run> runs) {
+    pages = make_shared<const vector<Run>>(move(runs));
+    references = 0;
+    for (const auto &p : *pages) { references += p.count; }
+
+    // Hash the content rather than the file, so a text and a run-length file of the same string match.
+    traceHash = Fnv1a(nullptr, 0);
+    for (const auto &p : *pages) {
+        traceHash = Fnv1a(&p.pageNumber, sizeof(p.pageNumber), traceHash);
+        traceHash = Fnv1a(&p.dirty, sizeof(p.dirty), traceHash);
+        traceHash = Fnv1a(&p.count, sizeof(p.count), traceHash);
+    }
+}
+
+int PageReplacement::getAlgorithmVersion(const string &algorithmName) {
+    static const unordered_map<string, int> versions = {
+        {"FIFO", 1}, {"Second Chance", 1}, {"ESC", 1}, {"LRU", 1}, {"LRU-LFU", 1}, {"ARB", 1}, {"Optimal", 1},
+        {"Sampled LRU", 1}, {"Sampled LFU", 1}, {"Write-Aware Optimal", 1}
+    };
+    auto it = versions.find(algorithmName);
+    return it == versions.end() ? 0 : it->second;
+}
+
+const vector<string> &PageReplacement::getAlgorithmNames() {
+    static const vector<string> names = {"FIFO", "Second Chance", "ESC", "LRU", "LRU-LFU", "ARB", "Optimal",
+                                         "Sampled LRU", "Sampled LFU", "Write-Aware Optimal"};
+    return names;
+}
+
+double PageReplacement::getDefaultParameter(const string &algorithmName) {
+    if (algorithmName == "ARB" || algorithmName == "Write-Aware Optimal") { return 1; }
+    if (algorithmName == "Sampled LRU" || algorithmName == "Sampled LFU") { return 5; }
+    return 0;
+}
+
+bool PageReplacement::isValidParameter(const string &algorithmName, const double parameter) {
+    if (algorithmName == "ARB" || algorithmName == "Sampled LRU" || algorithmName == "Sampled LFU") {
+        return parameter >= 1 && parameter <= numeric_limits<int>::max() && parameter == floor(parameter);
+    }
+    if (algorithmName == "Write-Aware Optimal") { return parameter >= 0 && isfinite(parameter); }
+    return parameter == 0;
+}
+
+size_t PageReplacement::getDistinctPages() {
+    unordered_set<PageNumber> distinct;
+    for (const auto &p : *pages) { distinct.insert(p.pageNumber); }
+    return distinct.size();
+}
+
+void PageReplacement::setCheckpoint(const string p_checkpointFile, const size_t p_checkpointInterval) {
+    checkpointFile = p_checkpointFile;
+    checkpointInterval = p_checkpointFile.empty() ? 0 : p_checkpointInterval;
+}
+
+void PageReplacement::setSegment(const size_t p_begin, const size_t p_end) {
+    segmented = p_begin < p_end;
+    segmentBegin = p_begin;
+    segmentEnd = p_end;
+}
+
+PerformanceReport PageReplacement::Simulate(const string &algorithmName, const double parameter) {
+    if (algorithmName == "FIFO") { return FIFO(); }
+    if (algorithmName == "Second Chance") { return SecondChance(); }
+    if (algorithmName == "ESC") { return EnhancedSecondChance(); }
+    if (algorithmName == "LRU") { return LRU(); }
+    if (algorithmName == "LRU-LFU") { return LRU_LFU(); }
+    if (algorithmName == "ARB") { return ARB(parameter >= 1 ? parameter : 1); } // parameter: interval, 0 would never shift the history
+    if (algorithmName == "Optimal") { return Optimal(); }
+    if (algorithmName == "Sampled LRU") { return SampledLRU(parameter >= 1 ? parameter : 5); } // parameter: samples
+    if (algorithmName == "Sampled LFU") { return SampledLFU(parameter >= 1 ? parameter : 5); }
+    if (algorithmName == "Write-Aware Optimal") { return WriteAwareOptimal(parameter >= 0 ? parameter : 1.0); } // parameter: alpha, 0 counts only faults
+
+    cerr << "Unknown algorithm: " << algorithmName << endl;
+    PerformanceReport unknown;
+    unknown.reset();
+    return unknown;
+}
+
+void PageReplacement::BeginSimulation(const string &algorithmName, const double p_parameter) {
+    parameter = p_parameter;
+    const bool resumed = !resumeFile.empty() && LoadState(resumeFile, algorithmName);
+    failed = !resumeFile.empty() && !resumed;
+    resumeFile.clear(); // A checkpoint is resumed by one simulation only
+    if (!resumed) {
+        state = PolicyState();
+        performance.reset();
+    }
+
+    simulationEnd = pages->size();
+    if (failed) {
+        // Starting cold would overwrite the checkpoint with less progress, so simulate nothing.
+        simulationEnd = 0;
+    } else if (segmented) {
+        // A segment reports only its own events, whether it starts cold or from a warm snapshot.
+        state.offset = segmentBegin;
+        simulationEnd = min(segmentEnd, pages->size());
+        performance.reset();
+    }
+    performance.algorithmName = algorithmName;
+    performance.memorySize = memorySize;
+}
+
+void PageReplacement::EndSimulation() {
+    if (!checkpointFile.empty() && !failed) { SaveState(checkpointFile); }
+}
+
+// State file:
+//   PolicyState 2
+//   <algorithm name>
+//   <trace hash> <frames> <parameter> <offset> <counter>
+//   <page faults> <interrupts> <disk writes>
+//   then one line for each of frames, memorySet, bitMap (page ref dirty), frequency (page count), memoryHits,
+//   evictionPool, metadata (page word), each starting with its number of entries.
+bool PageReplacement::SaveState(const string &stateFile) {
+    // Write a temporary file first, so an interrupted save never destroys the previous checkpoint.
+    const string temporaryFile = stateFile + ".tmp";
+    ofstream file(temporaryFile);
+    if (!file) { cerr << "Failed to open file: " << temporaryFile << endl; return false; }
+
+    file << "PolicyState 2\n" << performance.algorithmName << "\n";
+    file << traceHash << " " << memorySize << " " << FormatParameter(parameter) << " " << state.offset << " " << state.counter << "\n";
+    file << performance.pageFaults << " " << performance.interrupts << " " << performance.diskWrites << "\n";
+    file << state.frames.size();
+    for (const auto page : state.frames) { file << " " << page; }
+    file << "\n" << state.memorySet.size();
+    for (const auto page : state.memorySet) { file << " " << page; }
+    file << "\n" << state.bitMap.size();
+    for (const auto &b : state.bitMap) { file << " " << b.first << " " << b.second.ref << " " << b.second.dirty; }
+    file << "\n" << state.frequency.size();
+    for (const auto &f : state.frequency) { file << " " << f.first << " " << f.second; }
+    file << "\n" << state.memoryHits.size();
+    for (const auto page : state.memoryHits) { file << " " << page; }
+    file << "\n" << state.evictionPool.size();
+    for (const auto page : state.evictionPool) { file << " " << page; }
+    file << "\n" << state.metadata.size();
+    for (const auto &m : state.metadata) { file << " " << m.first << " " << m.second; }
+    file << "\n";
+    file.close();
+    if (!file) { cerr << "Failed to write file: " << temporaryFile << endl; return false; }
+
+    return rename(temporaryFile.c_str(), stateFile.c_str()) == 0;
+}
+
+bool PageReplacement::LoadState(const string &stateFile, const string &algorithmName) {
+    ifstream file(stateFile);
+    string magic, name;
+    int version;
+    if (!(file >> magic >> version) || magic != "PolicyState" || version != 2) {
+        cerr << "Not a checkpoint: " << stateFile << endl;
+        return false;
+    }
+    file.ignore(); // The end of the first line
+    getline(file, name);
+
+    uint64_t savedHash;
+    int savedMemorySize;
+    double savedParameter;
+    PolicyState loaded;
+    PerformanceReport counts;
+    counts.reset();
+    file >> savedHash >> savedMemorySize >> savedParameter >> loaded.offset >> loaded.counter;
+    file >> counts.pageFaults >> counts.interrupts >> counts.diskWrites;
+    if (!file) { cerr << "Truncated checkpoint: " << stateFile << endl; return false; }
+    if (name != algorithmName || savedHash != traceHash || savedMemorySize != memorySize || savedParameter != parameter) {
+        cerr << "The checkpoint " << stateFile << " belongs to another algorithm, reference string or configuration." << endl;
+        return false;
+    }
+
+    size_t n;
+    PageNumber page;
+    Bits bits;
+    int64_t count;
+    uint32_t word;
+    file >> n;
+    while (n-- > 0 && file >> page) { loaded.frames.push_back(page); }
+    file >> n;
+    while (n-- > 0 && file >> page) { loaded.memorySet.insert(page); }
+    file >> n;
+    while (n-- > 0 && file >> page >> bits.ref >> bits.dirty) { loaded.bitMap[page] = bits; }
+    file >> n;
+    while (n-- > 0 && file >> page >> count) { loaded.frequency[page] = count; }
+    file >> n;
+    while (n-- > 0 && file >> page) { loaded.memoryHits.insert(page); }
+    file >> n;
+    while (n-- > 0 && file >> page) { loaded.evictionPool.push_back(page); }
+    file >> n;
+    while (n-- > 0 && file >> page >> word) { loaded.metadata[page] = word; }
+    if (!file || loaded.offset > pages->size()) { cerr << "Truncated checkpoint: " << stateFile << endl; return false; }
+
+    state = move(loaded);
+    performance = counts;
+    return true;
+}
+
 PerformanceReport PageReplacement::FIFO() { 
     // init
-    performance.reset();
-    performance.algorithmName = "FIFO";
-    queue<int> memoryPageFrames; // Simulate page frames in memory with queue
-    unordered_set<int> memorySet; // Track whether page frames in memory are used with unordered_set
-    unordered_map<int, Bits> bitMap; // Track the reference bit and dirty bit of each page frame with unordered_map
+    BeginSimulation("FIFO");
+    deque<PageNumber> &memoryPageFrames = state.frames; // Simulate page frames in memory with queue
+    unordered_set<PageNumber> &memorySet = state.memorySet; // Track whether page frames in memory are used with unordered_set
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap; // Track the reference bit and dirty bit of each page frame with unordered_map
     // <page number, Bits>
 
     // Execute FIFO algorithm
-    for (const auto &p : pages) {
-        const int pageNumber = p[0];
-        const int dirty = p[1];
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
 
         // Check if the page exists in memory with Hash Set
         if (memorySet.find(pageNumber) == memorySet.end()) { // If page doesn't exist in memory
@@ -65,14 +297,14 @@ PerformanceReport PageReplacement::FIFO() {
             if (memoryPageFrames.size() < memorySize) {
                 // A memory isn't full and the page isn't found in the memory.
                 // Add a new page into the memory.
-                memoryPageFrames.push(pageNumber);
+                memoryPageFrames.push_back(pageNumber);
                 memorySet.insert(pageNumber);
                 bitMap[pageNumber] = {0, dirty};  // Set the dirty bit according to the input.
             } else {
                 // A memory is full and the page isn't found in the memory.
                 // Choose and Remove a victim page from the memory.
                 // that is, the page that entered the queue earliest.
-                int victim = memoryPageFrames.front(); memoryPageFrames.pop();
+                PageNumber victim = memoryPageFrames.front(); memoryPageFrames.pop_front();
                 memorySet.erase(victim);
 
                 if (bitMap[victim].dirty == 1) { // Write back into the disk.
@@ -80,9 +312,10 @@ PerformanceReport PageReplacement::FIFO() {
                     ++performance.interrupts;
                     bitMap[victim].dirty = 0;
                 }
+                bitMap.erase(victim); // Only the pages in memory keep their bits
 
                 // Add a new page into the memory.
-                memoryPageFrames.push(pageNumber);
+                memoryPageFrames.push_back(pageNumber);
                 memorySet.insert(pageNumber);
                 bitMap[pageNumber] = {0, dirty};  // Set the dirty bit according to the input.
             }
@@ -93,24 +326,29 @@ PerformanceReport PageReplacement::FIFO() {
                 bitMap[pageNumber].dirty = dirty; 
             }
         }
+
+        // The rest of the run are hits to the page which is in memory now.
+        if (p.count > 1) { bitMap[pageNumber].ref = 1; }
         
         // printQueue(memoryPageFrames);
+        if (CheckpointDue()) { SaveState(checkpointFile); }
     }
 
+    EndSimulation();
     return performance;
 }
 
 PerformanceReport PageReplacement::SecondChance() {
-    performance.reset();
-    performance.algorithmName = "Second Chance";
-    deque<int> memoryPageFrames;
-    unordered_set<int> memorySet;
-    unordered_map<int, Bits> bitMap;
+    BeginSimulation("Second Chance");
+    deque<PageNumber> &memoryPageFrames = state.frames;
+    unordered_set<PageNumber> &memorySet = state.memorySet;
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap;
 
     // Execute SecondChance algorithm
-    for (const auto &p : pages) {
-        const int pageNumber = p[0];
-        const int dirty = p[1];
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
 
         // Check if the page exists in memory with Hash Set
         if (memorySet.find(pageNumber) == memorySet.end()) { 
@@ -127,7 +365,7 @@ PerformanceReport PageReplacement::SecondChance() {
                 // Choose and Remove a victim page from the memory.
 
                 while (true) {
-                    int victim = memoryPageFrames.front(); // FIFO
+                    PageNumber victim = memoryPageFrames.front(); // FIFO
 
                     if (bitMap[victim].ref == 0) {  // If the reference bit is 0, remove it.
                         if (bitMap[victim].dirty == 1) { // Write back into the disk.
@@ -135,6 +373,7 @@ PerformanceReport PageReplacement::SecondChance() {
                             ++performance.interrupts;
                             bitMap[victim].dirty = 0;
                         }
+                        bitMap.erase(victim);
 
                         memoryPageFrames.pop_front();
                         memorySet.erase(victim);
@@ -158,25 +397,30 @@ PerformanceReport PageReplacement::SecondChance() {
                 bitMap[pageNumber].dirty = dirty; 
             }
         }
+
+        // The rest of the run are hits to the page which is in memory now.
+        if (p.count > 1) { bitMap[pageNumber].ref = 1; }
         
         // printQueue(memoryPageFrames);
+        if (CheckpointDue()) { SaveState(checkpointFile); }
     }
 
+    EndSimulation();
     return performance;
 }
 
 PerformanceReport PageReplacement::EnhancedSecondChance() {
-    performance.reset();
-    performance.algorithmName = "ESC";
-    deque<int> memoryPageFrames;
-    unordered_set<int> memorySet;
-    unordered_map<int, Bits> bitMap;
-    int counter = 0;
+    BeginSimulation("ESC");
+    deque<PageNumber> &memoryPageFrames = state.frames;
+    unordered_set<PageNumber> &memorySet = state.memorySet;
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap;
+    int &counter = state.counter; // Number of passes made over the circular queue
 
     // Execute Enhanced Second Chance algorithm
-    for (const auto &p : pages) {
-        const int pageNumber = p[0];
-        const int dirty = p[1];
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
 
         // Check if the page exists in memory with Hash Set
         if (memorySet.find(pageNumber) == memorySet.end()) { 
@@ -192,7 +436,7 @@ PerformanceReport PageReplacement::EnhancedSecondChance() {
                 // A memory is full and the page isn't found in the memory.
                 // Choose and Remove a victim page from the memory.
 
-                int victim = memoryPageFrames.front(); // FIFO
+                PageNumber victim = memoryPageFrames.front(); // FIFO
                 bool foundVictim = false;
                 
                 // Find the victim page based on the preference order
@@ -226,6 +470,7 @@ PerformanceReport PageReplacement::EnhancedSecondChance() {
                     ++performance.interrupts;
                     bitMap[victim].dirty = 0;
                 }
+                bitMap.erase(victim);
 
                 memoryPageFrames.pop_front();
                 memorySet.erase(victim);
@@ -243,24 +488,29 @@ PerformanceReport PageReplacement::EnhancedSecondChance() {
                 bitMap[pageNumber].dirty = dirty; 
             }
         }
+
+        // The rest of the run are hits to the page which is in memory now.
+        if (p.count > 1) { bitMap[pageNumber].ref = 1; }
         
         // printQueue(memoryPageFrames);
+        if (CheckpointDue()) { SaveState(checkpointFile); }
     }
 
+    EndSimulation();
     return performance;
 }
 
 // Optimal algorithm
 PerformanceReport PageReplacement::Optimal() {
-    performance.reset();
-    performance.algorithmName = "Optimal";
-    vector<int> memoryPageFrames;
-    unordered_map<int, Bits> bitMap;
+    BeginSimulation("Optimal");
+    deque<PageNumber> &memoryPageFrames = state.frames;
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap;
     
     // 1. Execute optimal algorithm.
-    for (int i = 0; i < pages.size(); ++i) {
-        const int pageNumber = pages[i][0];
-        const int dirty = pages[i][1];
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
         
         if (find(memoryPageFrames.begin(), memoryPageFrames.end(), pageNumber) == memoryPageFrames.end()) {
             ++performance.pageFaults;  // Page fault occurs when the page is not found in memory.
@@ -272,14 +522,15 @@ PerformanceReport PageReplacement::Optimal() {
                 bitMap[pageNumber] = {0, dirty};
             } else {
 
-                const int j = OptimalPredict(i + 1, memoryPageFrames);
-                int victim = memoryPageFrames[j];
+                const int j = OptimalPredict(state.offset, memoryPageFrames);
+                PageNumber victim = memoryPageFrames[j];
                 
                 if (bitMap[victim].dirty == 1) {
                     ++performance.diskWrites;
                     ++performance.interrupts;
                     bitMap[victim].dirty = 0;
                 }
+                bitMap.erase(victim);
 
                 memoryPageFrames[j] = pageNumber;
                 bitMap[pageNumber] = {0, dirty};
@@ -291,19 +542,27 @@ PerformanceReport PageReplacement::Optimal() {
                 bitMap[pageNumber].dirty = dirty; 
             }
         }
+
+        // The rest of the run are hits to the page which is in memory now.
+        if (p.count > 1) { bitMap[pageNumber].ref = 1; }
         // printVec(memory);
+
+        if (CheckpointDue()) { SaveState(checkpointFile); }
     }
+
+    EndSimulation();
     return performance;
 }
 
 // Find a victim for optimal
-int PageReplacement::OptimalPredict(const int index, const vector<int> &memory) {
-    int pre = -1, farthest = index;
+int PageReplacement::OptimalPredict(const size_t index, const deque<PageNumber> &memory) {
+    int pre = -1;
+    size_t farthest = index;
     for (int i = 0; i < memory.size(); ++i) {
-        int j;
+        size_t j;
         // Store the index (j) of pages which are going to be used recently in future
-        for (j = index; j < pages.size(); ++j) {
-            if (memory[i] == pages[j][0]) {
+        for (j = index; j < pages->size(); ++j) {
+            if (memory[i] == (*pages)[j].pageNumber) {
                 if (j > farthest) {
                     farthest = j;
                     pre = i;
@@ -312,7 +571,7 @@ int PageReplacement::OptimalPredict(const int index, const vector<int> &memory)
             }
         }
         // If a page is never used in future, return it.
-        if (j == pages.size()) { return i; }
+        if (j == pages->size()) { return i; }
     }
     // If all of the frames were not in future, return any of them, we return 0.
     // Otherwise we return pre.
@@ -323,19 +582,19 @@ int PageReplacement::OptimalPredict(const int index, const vector<int> &memory)
 // An additional reference bit is used to determine the victim, 
 // usually using 8 bits and updating the ARB for all pages in memory
 PerformanceReport PageReplacement::ARB(const int interval) {
-    performance.reset();
-    performance.algorithmName = "ARB";
-    int count = 0;
-    vector<int> memoryPageFrames; // A vector to store page frames in memory
-    unordered_map<int, Bits> bitMap;
-    unordered_set<int> memoryHits; // Track hit page frames in memory
+    BeginSimulation("ARB", interval);
+    int &count = state.counter; // References since the last update of the reference bits
+    deque<PageNumber> &memoryPageFrames = state.frames; // A vector to store page frames in memory
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap;
+    unordered_set<PageNumber> &memoryHits = state.memoryHits; // Track hit page frames in memory
     
     // Excute Additional-reference-bits (ARB)
-    for (const auto &p : pages) {
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
         int isInterrupt = 0; // init 
         // Column 0 is a page number and column 1 is a dirty bit.
-        const int pageNumber = p[0];
-        const int dirty = p[1];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
 
         // Check if the page exists in memory with vector
         if (find(memoryPageFrames.begin(), memoryPageFrames.end(), pageNumber) == memoryPageFrames.end()) {
@@ -354,7 +613,7 @@ PerformanceReport PageReplacement::ARB(const int interval) {
                 // To get and remove a victim with the least significant bit (LSB) (that is, the least referenced page),
                 // We need to know the position of the minimal reference bit
                 const int j = FindMinRefBit(memoryPageFrames, bitMap);
-                int victim = memoryPageFrames[j];
+                PageNumber victim = memoryPageFrames[j];
                 
                 if (bitMap[victim].dirty == 1) {
                     ++performance.diskWrites;
@@ -362,6 +621,7 @@ PerformanceReport PageReplacement::ARB(const int interval) {
                     bitMap[victim].dirty = 0;
                     isInterrupt = 1;
                 }
+                bitMap.erase(victim);
 
                 // replace the victim with new page
                 memoryPageFrames[j] = pageNumber;
@@ -383,13 +643,31 @@ PerformanceReport PageReplacement::ARB(const int interval) {
             UpdateARB(memoryPageFrames, bitMap, memoryHits);
             if (!isInterrupt) { ++performance.interrupts; }
         }
+
+        // The rest of the run are hits to the page which is in memory now.
+        // Hits between two updates of the reference bits have the same effect, so handle them together.
+        for (int64_t remaining = p.count - 1; remaining > 0; ) {
+            memoryHits.insert(pageNumber);
+            bitMap[pageNumber].ref = bitMap[pageNumber].ref | (1 << 7);
+            const int64_t hits = interval > count ? min<int64_t>(remaining, interval - count) : remaining;
+            count += hits;
+            remaining -= hits;
+            if (count == interval) {
+                count = 0;
+                UpdateARB(memoryPageFrames, bitMap, memoryHits);
+                ++performance.interrupts;
+            }
+        }
+
+        if (CheckpointDue()) { SaveState(checkpointFile); }
     }
 
+    EndSimulation();
     return performance;
 }
 
 // Find a victim for ARB
-int PageReplacement::FindMinRefBit(const vector<int> &memoryPageFrames, unordered_map<int, Bits> &bitMap) {
+int PageReplacement::FindMinRefBit(const deque<PageNumber> &memoryPageFrames, unordered_map<PageNumber, Bits> &bitMap) {
     int min = 256; // 8-bit information
     int minIndex = 0;
     // iterate through all page frames in the memory
@@ -403,28 +681,33 @@ int PageReplacement::FindMinRefBit(const vector<int> &memoryPageFrames, unordere
     return minIndex;
 }
 
-void PageReplacement::UpdateARB(const vector<int> &memoryPageFrames, unordered_map<int, Bits> &bitMap, unordered_set<int> &memoryHits) {
+void PageReplacement::UpdateARB(const deque<PageNumber> &memoryPageFrames, unordered_map<PageNumber, Bits> &bitMap, unordered_set<PageNumber> &memoryHits) {
     // Shift right the reference bit of all pages in the memory by 1 bit.
     for (const auto fm : memoryPageFrames) { bitMap[fm].ref >>= 1; }
     
     // If pages in the memory are referenced, their reference bit ^ 1000 0000(2).
-    for (const auto &h : memoryHits) { bitMap[h].ref &= (1 << 7); }
+    // A page evicted since the last update has no bits any more.
+    for (const auto &h : memoryHits) {
+        auto it = bitMap.find(h);
+        if (it != bitMap.end()) { it->second.ref &= (1 << 7); }
+    }
     memoryHits.clear();
 }
 
 PerformanceReport PageReplacement::LRU() {
     // init
-    performance.reset();
-    performance.algorithmName = "LRU";
-    list<int> memoryPageFrames; // Simulate page frames in memory with doubly linked list
-    unordered_map<int, list<int>::iterator> posMap; // Track the position of each page frame in the list with unordered_map
+    BeginSimulation("LRU");
+    list<PageNumber> memoryPageFrames(state.frames.begin(), state.frames.end()); // Simulate page frames in memory with doubly linked list
+    unordered_map<PageNumber, list<PageNumber>::iterator> posMap; // Track the position of each page frame in the list with unordered_map
     // <page number, iterator>
-    unordered_map<int, Bits> bitMap;
+    for (auto it = memoryPageFrames.begin(); it != memoryPageFrames.end(); ++it) { posMap[*it] = it; }
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap;
 
     // Execute LRU algorithm
-    for (const auto &p : pages) {
-        const int pageNumber = p[0];
-        const int dirty = p[1];
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
 
         // Check if the page exists in memory with Hash Map
         if (posMap.find(pageNumber) == posMap.end()) { // If page doesn't exist in memory
@@ -441,7 +724,7 @@ PerformanceReport PageReplacement::LRU() {
             } else {
                 // A memory is full and the page isn't found in the memory.
                 // Choose and Remove a victim page from the back of the list.
-                int victim = memoryPageFrames.back(); memoryPageFrames.pop_back();
+                PageNumber victim = memoryPageFrames.back(); memoryPageFrames.pop_back();
                 posMap.erase(victim);
 
                 if (bitMap[victim].dirty == 1) { // Write back into the disk.
@@ -449,6 +732,7 @@ PerformanceReport PageReplacement::LRU() {
                     ++performance.interrupts;
                     bitMap[victim].dirty = 0;
                 }
+                bitMap.erase(victim);
 
                 // Add a new page into the front of the list.
                 memoryPageFrames.push_front(pageNumber);
@@ -470,25 +754,44 @@ PerformanceReport PageReplacement::LRU() {
                 bitMap[pageNumber].dirty = dirty; 
             }
         }
+
+        // The rest of the run are hits to the page which is at the front of the list now.
+        if (p.count > 1) {
+            performance.interrupts += p.count - 1;
+            bitMap[pageNumber].ref = 1;
+        }
         
+        if (CheckpointDue()) {
+            state.frames.assign(memoryPageFrames.begin(), memoryPageFrames.end());
+            SaveState(checkpointFile);
+        }
     }
 
+    state.frames.assign(memoryPageFrames.begin(), memoryPageFrames.end());
+    EndSimulation();
     return performance;
 }
 
 PerformanceReport PageReplacement::LRU_LFU() {
     // init
-    performance.reset();
-    performance.algorithmName = "LRU-LFU";
-    list<int> memoryPageFrames; // Simulate page frames in memory with list
-    unordered_map<int, pair<list<int>::iterator, int>> memoryMap; // Track the position and frequency of each page frame in the list with unordered_map
+    BeginSimulation("LRU-LFU");
+    list<PageNumber> memoryPageFrames(state.frames.begin(), state.frames.end()); // Simulate page frames in memory with list
+    unordered_map<PageNumber, pair<list<PageNumber>::iterator, int64_t>> memoryMap; // Track the position and frequency of each page frame in the list with unordered_map
     // <page number, <iterator, frequency>>
-    unordered_map<int, Bits> bitsMap; // Track the reference bit and dirty bit of each page frame with unordered_map
+    for (auto it = memoryPageFrames.begin(); it != memoryPageFrames.end(); ++it) { memoryMap[*it] = make_pair(it, state.frequency[*it]); }
+    unordered_map<PageNumber, Bits> &bitsMap = state.bitMap; // Track the reference bit and dirty bit of each page frame with unordered_map
+    // Keep the checkpointed state in step with the list and the map.
+    auto saveFrames = [&]() {
+        state.frames.assign(memoryPageFrames.begin(), memoryPageFrames.end());
+        state.frequency.clear();
+        for (const auto &m : memoryMap) { state.frequency[m.first] = m.second.second; }
+    };
 
     // Execute LRU-LFU algorithm
-    for (const auto &p : pages) {
-        const int pageNumber = p[0];
-        const int dirty = p[1];
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
 
         // Check if the page exists in memory with Hash Map
         if (memoryMap.find(pageNumber) == memoryMap.end()) { // If page doesn't exist in memory
@@ -501,19 +804,19 @@ PerformanceReport PageReplacement::LRU_LFU() {
                 memoryPageFrames.push_front(pageNumber);
                 ++performance.interrupts;
                 auto it = memoryPageFrames.begin(); // Store the iterator of the new page
-                int freq = 1; // Set the frequency of the new page to 1
+                int64_t freq = 1; // Set the frequency of the new page to 1
                 memoryMap[pageNumber] = make_pair(it, freq); 
                 bitsMap[pageNumber] = {0, dirty}; // Set the reference bit and dirty bit according to the input
             } else {
                 // A memory is full and the page isn't found in the memory.
                 // Choose and Remove a victim page from the list based on LRU-LFU policy.
-                int victim = -1; // The page number of the victim
-                int minFreq = INT_MAX; // The minimum frequency among the pages in memory
+                PageNumber victim = -1; // The page number of the victim
+                int64_t minFreq = INT64_MAX; // The minimum frequency among the pages in memory
                 int minIndex = -1; // The index of the page with minimum frequency in the list
                 int index = 0; // The current index in the list
                 for (const auto &page : memoryPageFrames) { // Traverse the list from front to back
                     auto it = memoryMap[page].first; // Get the iterator of the current page
-                    int freq = memoryMap[page].second; // Get the frequency of the current page
+                    int64_t freq = memoryMap[page].second; // Get the frequency of the current page
                     if (freq < minFreq) { // Update the minimum frequency and the corresponding index and page number
                         minFreq = freq;
                         minIndex = index;
@@ -533,19 +836,20 @@ PerformanceReport PageReplacement::LRU_LFU() {
                     ++performance.interrupts;
                     bitsMap[victim].dirty = 0;
                 }
+                bitsMap.erase(victim);
 
                 // Add a new page into the front of the list with frequency 1.
                 memoryPageFrames.push_front(pageNumber);
                 ++performance.interrupts;
                 auto it = memoryPageFrames.begin(); // Store the iterator of the new page
-                int freq = 1; // Set the frequency of the new page to 1
+                int64_t freq = 1; // Set the frequency of the new page to 1
                 memoryMap[pageNumber] = make_pair(it, freq); 
                 bitsMap[pageNumber] = {0, dirty};  // Set the reference bit and dirty bit according to the input
             }
         } else {
             // The page is found in memory. Move it to the front of the list and increase its frequency by 1.
             auto it = memoryMap[pageNumber].first; // Get the iterator of the existing page
-            int freq = memoryMap[pageNumber].second; // Get the frequency of the existing page
+            int64_t freq = memoryMap[pageNumber].second; // Get the frequency of the existing page
             memoryPageFrames.erase(it); // Remove it from its current position
             memoryPageFrames.push_front(pageNumber); // Insert it to the front of the list
             ++performance.interrupts;
@@ -558,8 +862,22 @@ PerformanceReport PageReplacement::LRU_LFU() {
                 bitsMap[pageNumber].dirty = dirty; 
             }
         }
+
+        // The rest of the run are hits to the page which is at the front of the list now.
+        if (p.count > 1) {
+            performance.interrupts += p.count - 1;
+            memoryMap[pageNumber].second += p.count - 1;
+            bitsMap[pageNumber].ref = 1;
+        }
+
+        if (CheckpointDue()) {
+            saveFrames();
+            SaveState(checkpointFile);
+        }
     }
 
+    saveFrames();
+    EndSimulation();
     return performance;
 }
 
@@ -5,15 +5,46 @@
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 #include <queue>
+#include <deque>
+#include <cstdint>
+#include <memory>
 
 using namespace std;
 
+typedef int64_t PageNumber; // 64-bit page ids, so sparse address spaces with millions of pages fit
+
+typedef struct Reference { // One line of a reference string file
+    PageNumber pageNumber; // page number
+    int dirty; // dirty bit
+} Reference;
+
+typedef struct Run { // Back-to-back references to the same page
+    PageNumber pageNumber; // page number
+    int dirty; // OR of the dirty bits of the references
+    int64_t count; // number of references
+} Run;
+
+void AppendRun(vector<Run> &runs, const Run &run); // Append a run, merging it with the last run of the same page
+
 typedef struct Bits { // You can use both reference and dirty bits
     int ref; // reference bit
     int dirty; // dirty bit
 } Bits;
 
+typedef struct PolicyState { // Everything a policy needs to continue a simulation, see SaveState()
+    size_t offset = 0; // Index of the next run to simulate
+    deque<PageNumber> frames; // Page frames in memory, in the order the policy keeps them (queue, clock, list)
+    unordered_set<PageNumber> memorySet; // Pages found in memory (FIFO, Second Chance, ESC, sampled policies)
+    unordered_map<PageNumber, Bits> bitMap; // Reference and dirty bits of the pages in memory; for ARB, ref is the history byte
+    unordered_map<PageNumber, int64_t> frequency; // LRU-LFU: reference count of each page frame, as runs may hold billions
+    unordered_set<PageNumber> memoryHits; // ARB: pages referenced since the last update
+    vector<PageNumber> evictionPool; // Sampled policies: candidates kept from earlier samples
+    unordered_map<PageNumber, uint32_t> metadata; // Sampled policies: one 32-bit word of each page frame
+    int counter = 0; // ESC: passes made over the queue; ARB: references since the last update
+} PolicyState;
+
 class PageReplacement {
 public:
     PageReplacement(const int p_memorySize, const string p_fileName);
@@ -21,7 +52,39 @@ public:
 
     void setMemorySize(const int p_memorySize) { memorySize = p_memorySize; }
     void setFileName(const string p_fileName);
-    int getFileSize() { return pages.size(); }
+    void setReferences(vector<Reference> p_pages, const string p_name); // Use an in-memory reference string
+    void setRuns(vector<Run> p_runs, const string p_name); // The same, already collapsed into runs
+    size_t getFileSize() { return references; }
+    size_t getDistinctPages(); // Number of different pages referenced
+    uint64_t getTraceHash() { return traceHash; } // Fingerprint of the reference string content
+
+    // Bump an algorithm's version whenever a change alters its results, so cached results go stale.
+    static int getAlgorithmVersion(const string &algorithmName);
+    static const vector<string> &getAlgorithmNames(); // Every algorithm Simulate() runs
+    // Parameter of an algorithm when none is given: ARB interval 1, 5 samples, alpha 1, 0 for the others.
+    static double getDefaultParameter(const string &algorithmName);
+    // An ARB interval or a number of samples is an integer from 1, alpha is at least 0, and the other algorithms take 0,
+    // so every accepted parameter is simulated as it is cached and checkpointed.
+    static bool isValidParameter(const string &algorithmName, const double parameter);
+
+    // Checkpoint and resume. Offsets count runs (back-to-back references to one page), see getRunCount().
+    // Save the state into p_checkpointFile every p_checkpointInterval runs and when a simulation stops (0: only when it stops).
+    void setCheckpoint(const string p_checkpointFile, const size_t p_checkpointInterval = 0);
+    // The next simulation continues from a checkpoint of the same algorithm, trace, frames and parameter.
+    // If the checkpoint can't be loaded, that simulation stops before its first run and saves no checkpoint, see hasFailed().
+    void resume(const string p_resumeFile) { resumeFile = p_resumeFile; }
+    bool hasFailed() { return failed; } // The last simulation couldn't resume its checkpoint
+    // Simulate only the runs [p_begin, p_end). A segment starts cold, or from the resumed checkpoint as warm state,
+    // and reports only its own faults, interrupts and writes.
+    void setSegment(const size_t p_begin, const size_t p_end);
+    size_t getRunCount() { return pages->size(); }
+    const vector<Run> &getRuns() { return *pages; }
+
+    // Run an algorithm by its report name ("FIFO", "Second Chance", "ESC", "LRU", "LRU-LFU", "ARB", "Optimal",
+    // "Sampled LRU", "Sampled LFU", "Write-Aware Optimal"). The write-aware optimal always simulates the whole trace, without checkpoints.
+    // The parameter is the ARB interval, the number of samples or alpha. An interval or a number of samples below 1,
+    // or a negative alpha, runs the default parameter; the spec and the command line accept only isValidParameter() values.
+    PerformanceReport Simulate(const string &algorithmName, const double parameter = -1);
 
     // Algorithms
     PerformanceReport FIFO();
@@ -31,19 +94,42 @@ public:
     PerformanceReport Optimal();
     PerformanceReport LRU();
     PerformanceReport LRU_LFU();
+    // Approximations which evict the worst of K sampled frames, see sampledPolicies.cpp
+    PerformanceReport SampledLRU(const int samples = 5);
+    PerformanceReport SampledLFU(const int samples = 5);
+    // Offline, minimizing page faults + alpha x disk writes, see writeAwareOptimal.cpp
+    PerformanceReport WriteAwareOptimal(const double alpha = 1.0);
+    double WriteAwareLowerBound(const double alpha = 1.0); // No schedule costs less than this
 
 private:
     PerformanceReport performance;
     int memorySize;
     string fileName;
-    vector<vector<int>> pages;
+    shared_ptr<const vector<Run>> pages; // The reference string, with back-to-back repeats collapsed into runs; copies share it
+    size_t references; // Number of references in the reference string
+    uint64_t traceHash; // FNV-1a hash of the runs
+
+    PolicyState state; // State of the running simulation
+    double parameter; // Parameter of the running simulation (ARB interval, samples)
+    size_t simulationEnd; // The running simulation stops before this run
+    string checkpointFile, resumeFile;
+    bool failed; // The resumed checkpoint couldn't be loaded, so the running simulation does nothing
+    size_t checkpointInterval;
+    bool segmented; // Simulate only the runs [segmentBegin, segmentEnd)
+    size_t segmentBegin, segmentEnd;
     
     // Member functions
-    int SecondChanceVictim(const int index, deque<int> &memory, unordered_map<int, Bits> &memoryMap);
-    int ESCVictim(const int index, deque<int> &memory, unordered_map<int, Bits> &memoryMap);
-    int OptimalPredict(const int index, const vector<int> &memory); // Find a victim for optimal
-    int FindMinRefBit(const vector<int> &memory, unordered_map<int, Bits> &memortBits); // Find a victim for ARB
-    void UpdateARB(const vector<int> &memory, unordered_map<int, Bits> &memortBits, unordered_set<int> &memoryHit); // For ARB
+    void SetPages(vector<Run> runs); // Count the references and hash the runs
+    void BeginSimulation(const string &algorithmName, const double p_parameter = 0); // Start cold or from the resumed checkpoint
+    void EndSimulation();
+    bool CheckpointDue() { return checkpointInterval > 0 && state.offset % checkpointInterval == 0; }
+    bool SaveState(const string &stateFile);
+    bool LoadState(const string &stateFile, const string &algorithmName);
+    PerformanceReport Sampled(const string &algorithmName, const int samples, const bool lfu); // For sampled LRU and LFU
+    void WriteAwareIntervals(const double alpha, const bool lowerBound, vector<size_t> &next, vector<int64_t> &weight); // For write-aware optimal
+    int OptimalPredict(const size_t index, const deque<PageNumber> &memory); // Find a victim for optimal
+    int FindMinRefBit(const deque<PageNumber> &memory, unordered_map<PageNumber, Bits> &memortBits); // Find a victim for ARB
+    void UpdateARB(const deque<PageNumber> &memory, unordered_map<PageNumber, Bits> &memortBits, unordered_set<PageNumber> &memoryHit); // For ARB
 };
 
 #endif // __pageReplacement__
\ No newline at end of file
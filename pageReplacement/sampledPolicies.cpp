@@ -0,0 +1,146 @@
+#include "pageReplacement.hpp"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// Sampled approximate LRU and LFU, in the manner of Redis' maxmemory policies
+// A fault with full memory samples K resident pages at random into a pool of eviction candidates,
+// keeps the best evictionPoolSize of them and evicts the best one. The cost of a reference doesn't depend
+// on the number of frames, and each page keeps one 32-bit word of metadata (state.metadata):
+//   LRU: the run index of the last access (a 32-bit clock, wrapping around);
+//   LFU: the time of the last decay in 16 bits, then a logarithmic 8-bit counter.
+
+static const int evictionPoolSize = 16;
+static const int lfuInitialCount = 5;   // A new page can outlive pages which were referenced once long ago
+static const int lfuLogFactor = 10;     // The counter reaches 255 after about a million references
+static const int lfuDecayShift = 10;    // The counter drops by one every 1024 runs without a reference
+
+// A random number in [0, 1) from the run index and a sequence number, so a resumed checkpoint draws the same
+// numbers as an uninterrupted simulation.
+static double SampleRandom(const uint64_t offset, const uint64_t i) {
+    uint64_t z = offset * 0x9E3779B97F4A7C15ULL + i + 0x632BE59BD9B4E019ULL; // splitmix64
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint32_t LfuTime(const size_t offset) { return (offset >> lfuDecayShift) & 0xFFFF; }
+
+static int LfuDecayedCount(const uint32_t word, const size_t offset) {
+    const uint32_t periods = (LfuTime(offset) - (word >> 8)) & 0xFFFF; // The 16-bit time wraps around
+    const int count = word & 0xFF;
+    return periods >= (uint32_t)count ? 0 : count - periods;
+}
+
+static int LfuIncrement(int count, const size_t offset, const uint64_t i) {
+    if (count == 255) { return count; }
+    const double p = 1.0 / ((max(count - lfuInitialCount, 0)) * lfuLogFactor + 1);
+    return SampleRandom(offset, i) < p ? count + 1 : count;
+}
+
+PerformanceReport PageReplacement::SampledLRU(const int samples) {
+    return Sampled("Sampled LRU", samples, false);
+}
+
+PerformanceReport PageReplacement::SampledLFU(const int samples) {
+    return Sampled("Sampled LFU", samples, true);
+}
+
+PerformanceReport PageReplacement::Sampled(const string &algorithmName, const int samples, const bool lfu) {
+    BeginSimulation(algorithmName, samples);
+    deque<PageNumber> &memoryPageFrames = state.frames; // Frame slots, sampled by index
+    unordered_set<PageNumber> &memorySet = state.memorySet;
+    unordered_map<PageNumber, Bits> &bitMap = state.bitMap;
+    unordered_map<PageNumber, uint32_t> &metadata = state.metadata; // One 32-bit word for each page frame
+    vector<PageNumber> &evictionPool = state.evictionPool;
+    unordered_map<PageNumber, size_t> slot; // <page number, index in memoryPageFrames>
+    for (size_t i = 0; i < memoryPageFrames.size(); ++i) { slot[memoryPageFrames[i]] = i; }
+
+    // The larger, the better to evict: idle runs for LRU, 255 - the decayed counter for LFU.
+    auto score = [&](const PageNumber page) -> int64_t {
+        const uint32_t word = metadata[page];
+        if (lfu) { return 255 - LfuDecayedCount(word, state.offset); }
+        return static_cast<uint32_t>(static_cast<uint32_t>(state.offset) - word);
+    };
+    auto touch = [&](const PageNumber page, const int64_t count, const bool fault) {
+        if (!lfu) {
+            metadata[page] = static_cast<uint32_t>(state.offset);
+            return;
+        }
+        int counter = fault ? lfuInitialCount : LfuDecayedCount(metadata[page], state.offset);
+        for (int64_t j = fault ? 1 : 0; j < count; ++j) { counter = LfuIncrement(counter, state.offset, j); }
+        metadata[page] = (LfuTime(state.offset) << 8) | counter;
+    };
+    vector<pair<int64_t, PageNumber>> candidates;
+
+    // Execute sampled LRU/LFU algorithm
+    while (state.offset < simulationEnd) {
+        const Run &p = (*pages)[state.offset++];
+        const PageNumber pageNumber = p.pageNumber;
+        const int dirty = p.dirty;
+
+        if (memorySet.find(pageNumber) == memorySet.end()) {
+            ++performance.pageFaults;  // Page fault occurs when the page is not found in memory.
+            ++performance.interrupts;  // An interrupt is generated when a page fault occurs.
+
+            if (memoryPageFrames.size() < memorySize) {
+                slot[pageNumber] = memoryPageFrames.size();
+                memoryPageFrames.push_back(pageNumber);
+            } else {
+                // Sample K frames into the pool, keep the best candidates and evict the best one.
+                candidates.clear();
+                for (const auto page : evictionPool) { candidates.push_back({score(page), page}); }
+                for (int i = 0; i < samples; ++i) {
+                    const size_t j = SampleRandom(state.offset, (uint64_t(1) << 32) + i) * memoryPageFrames.size();
+                    const PageNumber page = memoryPageFrames[j];
+                    if (find(evictionPool.begin(), evictionPool.end(), page) != evictionPool.end()) { continue; }
+                    evictionPool.push_back(page);
+                    candidates.push_back({score(page), page});
+                }
+                // Best first; ties go to the smaller page number, so the order of the pool doesn't matter.
+                auto better = [](const pair<int64_t, PageNumber> &a, const pair<int64_t, PageNumber> &b) {
+                    return a.first != b.first ? a.first > b.first : a.second < b.second;
+                };
+                if (candidates.size() > evictionPoolSize + 1) {
+                    nth_element(candidates.begin(), candidates.begin() + evictionPoolSize, candidates.end(), better);
+                    candidates.resize(evictionPoolSize + 1);
+                }
+                iter_swap(candidates.begin(), min_element(candidates.begin(), candidates.end(), better));
+                evictionPool.clear();
+                for (size_t i = 1; i < candidates.size(); ++i) { evictionPool.push_back(candidates[i].second); }
+
+                PageNumber victim = candidates[0].second;
+                if (bitMap[victim].dirty == 1) { // Write back into the disk.
+                    ++performance.diskWrites;
+                    ++performance.interrupts;
+                    bitMap[victim].dirty = 0;
+                }
+                memorySet.erase(victim);
+                metadata.erase(victim);
+                bitMap.erase(victim); // Only the resident pages keep metadata
+
+                // The new page takes the victim's frame.
+                const size_t j = slot[victim];
+                slot.erase(victim);
+                memoryPageFrames[j] = pageNumber;
+                slot[pageNumber] = j;
+            }
+            memorySet.insert(pageNumber);
+            bitMap[pageNumber] = {0, dirty};
+            touch(pageNumber, p.count, true);
+        } else {
+            if (dirty == 1 && bitMap[pageNumber].dirty == 0) {
+                bitMap[pageNumber].dirty = dirty;
+            }
+            touch(pageNumber, p.count, false);
+        }
+
+        if (CheckpointDue()) { SaveState(checkpointFile); }
+    }
+
+    EndSimulation();
+    return performance;
+}
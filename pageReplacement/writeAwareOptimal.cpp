@@ -0,0 +1,233 @@
+#include "pageReplacement.hpp"
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// Write-aware offline optimal
+// The cost of a schedule is page faults + alpha x disk writes.
+// Keeping page p in memory from its run i to its next run j saves the fault at j, and if p is dirty
+// between them, the write-back of an eviction. A page that is never referenced again can still be kept
+// to the end to avoid its write-back. Choosing which intervals to keep, with at most (frames - 1) of them
+// covering any run (one frame serves the run itself), is a min-cost flow over the runs: the intervals
+// form an interval graph, so the flow is integral and as good as the linear relaxation.
+//
+// With dirty pages an exact minimum is NP-hard, because the write-back is paid once per write however
+// many intervals around it are broken. So two flows are solved:
+//   - WriteAwareOptimal() charges every broken dirty interval a full write-back, and replays the chosen
+//     intervals with the real costs to get an achievable schedule;
+//   - WriteAwareLowerBound() shares the write-back among the intervals after each write, so no schedule
+//     can cost less than its minimum.
+
+static const int64_t costScale = 1 << 20; // Costs are fixed point, so the flow works on integers
+
+// Successive shortest paths with Dijkstra and potentials. The line arcs s -> s + 1 carry the free frames
+// through run s; an interval arc from run t + 1 to run next[t] holds one frame for the runs strictly between.
+// Returns the total weight of the kept intervals and marks them in kept.
+static int64_t KeepIntervals(const size_t n, const int units, const vector<size_t> &next,
+                             const vector<int64_t> &weight, vector<char> &kept) {
+    kept.assign(n, 0);
+    int64_t saved = 0;
+
+    // Forward star graph; the residual arc of edge e is e ^ 1.
+    vector<int> head(n + 1, -1), nextEdge, to, capacity;
+    vector<int64_t> cost;
+    vector<size_t> intervalEdge(n, SIZE_MAX);
+    auto addEdge = [&](const size_t u, const size_t v, const int cap, const int64_t c) {
+        to.push_back(v); capacity.push_back(cap); cost.push_back(c); nextEdge.push_back(head[u]); head[u] = to.size() - 1;
+        to.push_back(u); capacity.push_back(0); cost.push_back(-c); nextEdge.push_back(head[v]); head[v] = to.size() - 1;
+    };
+    for (size_t s = 0; s < n; ++s) { addEdge(s, s + 1, units, 0); }
+    for (size_t t = 0; t < n; ++t) {
+        if (weight[t] <= 0) { continue; }
+        if (t + 1 == next[t]) {
+            // Nothing lies between the two runs, so keeping the page costs no frame.
+            kept[t] = 1;
+            saved += weight[t];
+        } else if (units > 0) {
+            intervalEdge[t] = to.size();
+            addEdge(t + 1, next[t], 1, -weight[t]);
+        }
+    }
+    if (units <= 0) { return saved; }
+
+    // Every arc goes forward, so the first potentials are shortest paths in run order.
+    const int64_t infinity = numeric_limits<int64_t>::max() / 4;
+    vector<int64_t> potential(n + 1, infinity), dist(n + 1);
+    potential[0] = 0;
+    for (size_t u = 0; u <= n; ++u) {
+        for (int e = head[u]; e != -1; e = nextEdge[e]) {
+            if (capacity[e] > 0 && potential[u] + cost[e] < potential[to[e]]) { potential[to[e]] = potential[u] + cost[e]; }
+        }
+    }
+
+    vector<int> parentEdge(n + 1);
+    vector<char> done(n + 1);
+    for (int flow = 0; flow < units; ) {
+        fill(dist.begin(), dist.end(), infinity);
+        fill(done.begin(), done.end(), 0);
+        priority_queue<pair<int64_t, size_t>, vector<pair<int64_t, size_t>>, greater<pair<int64_t, size_t>>> heap;
+        dist[0] = 0;
+        heap.push({0, 0});
+        while (!heap.empty()) {
+            const size_t u = heap.top().second; heap.pop();
+            if (done[u]) { continue; }
+            done[u] = 1;
+            if (u == n) { break; } // Nodes after the sink keep their potentials, see below
+            for (int e = head[u]; e != -1; e = nextEdge[e]) {
+                const size_t v = to[e];
+                const int64_t d = dist[u] + cost[e] + potential[u] - potential[v];
+                if (capacity[e] > 0 && d < dist[v]) {
+                    dist[v] = d;
+                    parentEdge[v] = e;
+                    heap.push({d, v});
+                }
+            }
+        }
+        if (dist[n] >= infinity) { break; }
+
+        // The remaining frames can always flow along the line at cost 0, so stop once a path doesn't save anything.
+        const int64_t pathCost = dist[n] + potential[n] - potential[0];
+        if (pathCost >= 0) { break; }
+
+        int push = units - flow;
+        for (size_t v = n; v != 0; v = to[parentEdge[v] ^ 1]) { push = min(push, capacity[parentEdge[v]]); }
+        for (size_t v = n; v != 0; v = to[parentEdge[v] ^ 1]) {
+            capacity[parentEdge[v]] -= push;
+            capacity[parentEdge[v] ^ 1] += push;
+        }
+        flow += push;
+        saved -= pathCost * push;
+
+        // Capping the distances at the sink keeps every reduced cost non-negative after an early stop.
+        for (size_t v = 0; v <= n; ++v) { potential[v] += done[v] ? dist[v] : dist[n]; }
+    }
+
+    for (size_t t = 0; t < n; ++t) {
+        if (intervalEdge[t] != SIZE_MAX && capacity[intervalEdge[t]] == 0) { kept[t] = 1; }
+    }
+    return saved;
+}
+
+void PageReplacement::WriteAwareIntervals(const double alpha, const bool lowerBound, vector<size_t> &next, vector<int64_t> &weight) {
+    const size_t n = pages->size();
+    next.assign(n, n);
+    weight.assign(n, 0);
+
+    // next[t]: the next run of the same page, n if there is none.
+    unordered_map<PageNumber, size_t> nextRun;
+    for (size_t t = n; t-- > 0; ) {
+        auto it = nextRun.find((*pages)[t].pageNumber);
+        if (it != nextRun.end()) { next[t] = it->second; }
+        nextRun[(*pages)[t].pageNumber] = t;
+    }
+
+    // A write starts a dirty gap that lasts until the next write of the page.
+    // Evicting the page anywhere in the gap costs one write-back.
+    vector<int64_t> gap(n, -1), gapSize;
+    unordered_map<PageNumber, int64_t> currentGap;
+    for (size_t t = 0; t < n; ++t) {
+        const PageNumber pageNumber = (*pages)[t].pageNumber;
+        if ((*pages)[t].dirty == 1) {
+            currentGap[pageNumber] = gapSize.size();
+            gapSize.push_back(0);
+        }
+        auto it = currentGap.find(pageNumber);
+        if (it != currentGap.end()) {
+            gap[t] = it->second;
+            ++gapSize[gap[t]];
+        }
+    }
+
+    const int64_t writeCost = llround(alpha * costScale);
+    for (size_t t = 0; t < n; ++t) {
+        weight[t] = next[t] < n ? costScale : 0; // The fault at the next run
+        if (gap[t] >= 0) {
+            weight[t] += lowerBound ? writeCost / gapSize[gap[t]] : writeCost;
+        }
+    }
+}
+
+PerformanceReport PageReplacement::WriteAwareOptimal(const double alpha) {
+    failed = false; // Never resumed
+    performance.reset();
+    performance.algorithmName = "Write-Aware Optimal";
+    performance.memorySize = memorySize;
+    if (memorySize < 1) { cerr << "Write-Aware Optimal needs at least one frame" << endl; return performance; }
+
+    const size_t n = pages->size();
+    vector<size_t> next;
+    vector<int64_t> weight;
+    vector<char> kept;
+    WriteAwareIntervals(alpha, false, next, weight);
+    KeepIntervals(n, memorySize - 1, next, weight, kept);
+
+    // Replay the schedule. On a fault, a page whose interval isn't kept makes room:
+    // a clean one first (no write-back), then the one used farthest in the future.
+    vector<PageNumber> memoryPageFrames;
+    unordered_map<PageNumber, size_t> lastRun; // Last run of each page in memory
+    unordered_map<PageNumber, Bits> bitMap;
+    for (size_t t = 0; t < n; ++t) {
+        const PageNumber pageNumber = (*pages)[t].pageNumber;
+        const int dirty = (*pages)[t].dirty;
+
+        if (lastRun.find(pageNumber) == lastRun.end()) {
+            ++performance.pageFaults;  // Page fault occurs when the page is not found in memory.
+            ++performance.interrupts;  // An interrupt is generated when a page fault occurs.
+
+            if (memoryPageFrames.size() < memorySize) {
+                memoryPageFrames.push_back(pageNumber);
+            } else {
+                int j = -1;
+                for (int i = 0; i < memoryPageFrames.size(); ++i) {
+                    const size_t r = lastRun[memoryPageFrames[i]];
+                    if (kept[r]) { continue; }
+                    if (j == -1) { j = i; continue; }
+                    const size_t best = lastRun[memoryPageFrames[j]];
+                    const int clean = bitMap[memoryPageFrames[i]].dirty == 0, bestClean = bitMap[memoryPageFrames[j]].dirty == 0;
+                    if (clean > bestClean || (clean == bestClean && next[r] > next[best])) { j = i; }
+                }
+                if (j == -1) { // With at least one frame, the flow leaves a frame for every run, so KeepIntervals() is wrong
+                    cerr << "Write-Aware Optimal: every page in memory is kept at run " << t << endl;
+                    abort();
+                }
+
+                PageNumber victim = memoryPageFrames[j];
+                if (bitMap[victim].dirty == 1) {
+                    ++performance.diskWrites;
+                    ++performance.interrupts;
+                    bitMap[victim].dirty = 0;
+                }
+                lastRun.erase(victim);
+                memoryPageFrames[j] = pageNumber;
+            }
+            bitMap[pageNumber] = {0, dirty};
+        } else if (bitMap[pageNumber].dirty == 0 && dirty == 1) {
+            bitMap[pageNumber].dirty = dirty;
+        }
+        lastRun[pageNumber] = t;
+    }
+
+    return performance;
+}
+
+double PageReplacement::WriteAwareLowerBound(const double alpha) {
+    if (memorySize < 1) { return 0; } // No schedule exists
+    const size_t n = pages->size();
+    vector<size_t> next;
+    vector<int64_t> weight;
+    vector<char> kept;
+    WriteAwareIntervals(alpha, true, next, weight);
+    const int64_t saved = KeepIntervals(n, memorySize - 1, next, weight, kept);
+
+    // Every page faults once, then every interval that isn't kept costs its weight.
+    int64_t total = 0;
+    for (const auto w : weight) { total += w; }
+    return getDistinctPages() + static_cast<double>(total - saved) / costScale;
+}
@@ -2,9 +2,22 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <sstream>
+#include <cmath>
+#include <string>
 
 using namespace std;
-namespace fs = std::__fs::filesystem;
+namespace fs = std::filesystem;
+
+string FormatParameter(const double parameter) {
+    if (fabs(parameter) < 1e15 && parameter == static_cast<int64_t>(parameter)) { return to_string(static_cast<int64_t>(parameter)); }
+    for (int precision = 1; ; ++precision) {
+        ostringstream text;
+        text.precision(precision);
+        text << parameter;
+        if (precision >= 17 || stod(text.str()) == parameter) { return text.str(); }
+    }
+}
 
 void PerformanceReport::printReport(const int n) {
     switch (n) {
@@ -22,7 +35,7 @@ void PerformanceReport::printReport(const int n) {
     }
 }
 
-void PerformanceReport::writeCsvReport(const string referenceStringName, int memorySize) {
+void PerformanceReport::writeCsvReport(const string referenceStringName, int memorySize, const double parameter) {
     fstream csvFile;
     // cout << memorySize << endl; // check size
     string dataDir = "../data";
@@ -33,11 +46,10 @@ void PerformanceReport::writeCsvReport(const string referenceStringName, int mem
         csvFile.seekg(0, ios::end); // 檔案指標移到末尾
         streampos csvFileSize = csvFile.tellg(); // 取得指標位置，即檔案大小
         if (csvFileSize == 0) {
-            csvFile << "algorithmName" << ","<< "referenceStringName" << "," << "memorySize" << "," << "pageFaults" << "," << "interrupts" << "," << "diskWrites" << endl; // title name
-            csvFile << algorithmName << ","<< referenceStringName << "," << memorySize << "," << pageFaults << "," << interrupts << "," << diskWrites << endl;
-        } else {
-            csvFile << algorithmName << "," << referenceStringName << "," << memorySize << "," << pageFaults << "," << interrupts << "," << diskWrites << endl;
+            csvFile << "algorithmName" << ","<< "referenceStringName" << "," << "memorySize" << "," << "parameter" << "," << "pageFaults" << "," << "interrupts" << "," << "diskWrites" << endl; // title name
         }
+        csvFile << algorithmName << "," << referenceStringName << "," << memorySize << "," << FormatParameter(parameter) << ","
+                << pageFaults << "," << interrupts << "," << diskWrites << endl;
 
         csvFile.close();
     } else { 
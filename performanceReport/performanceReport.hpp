@@ -2,6 +2,7 @@
 #define __performanceReport__
 
 #include <string>
+#include <cstdint>
 
 using namespace std;
 
@@ -17,11 +18,15 @@ public:
 
     void printReport(const int n = 1);
 
-    void writeCsvReport(const string referenceStringName, int memorySize);
+    void writeCsvReport(const string referenceStringName, int memorySize, const double parameter = 0);
 
-    int memorySize, pageFaults, interrupts, diskWrites;
+    int memorySize;
+    int64_t pageFaults, interrupts, diskWrites;
     bool hasHeader = false;
     string algorithmName;
 };
 
+// Shortest text which reads back as the same number: "20" for 20, "0.5" for 0.5
+string FormatParameter(const double parameter);
+
 #endif // __performanceReport__
\ No newline at end of file
@@ -1,22 +1,33 @@
 #include "referenceString.hpp"
+#include "../runLengthTrace/runLengthTrace.hpp"
+#include "../resultCache/resultCache.hpp"
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <random>
 #include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
 
 using namespace std;
 
 ReferenceStringGenerator::ReferenceStringGenerator(
-    const int p_dataSize, const int p_referenceSize, const double p_dirtyRate)
+    const int p_dataSize, const int p_referenceSize, const double p_dirtyRate, const unsigned int p_seed)
     : dataSize(p_dataSize), 
     referenceSize(p_referenceSize),
     dirtyRate(p_dirtyRate), 
-    generator(rd()),
+    seed(p_seed),
+    generator(p_seed),
     referenceDst(1, referenceSize), 
     probabilityDst(0, 1) {}
 
 void ReferenceStringGenerator::UniformRandom(const int p_referenceRange, const string &fileName) {
+    ostringstream parameters;
+    parameters << "UniformRandom " << p_referenceRange;
+    if (ReuseStringFile(fileName, parameters.str())) { return; }
+
     uniform_int_distribution<int> rangeDst(1, p_referenceRange);
     vector<pair<int, int>> referenceString;
     int p_dataSize = dataSize;
@@ -37,6 +48,10 @@ void ReferenceStringGenerator::UniformRandom(const int p_referenceRange, const s
 }
 
 void ReferenceStringGenerator::LocalityUniformRandom(const int p_referenceRange, const double subsetRateA, const double subsetRateB, const string &fileName) {
+    ostringstream parameters;
+    parameters << setprecision(17) << "LocalityUniformRandom " << p_referenceRange << " " << subsetRateA << " " << subsetRateB;
+    if (ReuseStringFile(fileName, parameters.str())) { return; }
+
     vector<pair<int, int>> referenceString;
     int p_dataSize = dataSize;
     uniform_int_distribution<int> rangeDst(1, p_referenceRange);
@@ -61,39 +76,85 @@ void ReferenceStringGenerator::LocalityUniformRandom(const int p_referenceRange,
 }
 
 void ReferenceStringGenerator::NormalRandom(const int mean, const int standardDeviation, const string &fileName) {
+    ostringstream parameters;
+    parameters << "NormalRandom " << mean << " " << standardDeviation;
+    if (ReuseStringFile(fileName, parameters.str())) { return; }
+
     normal_distribution<double> referenceDst(mean, standardDeviation);
     
+    vector<pair<int, int>> referenceString;
     int p_dataSize = dataSize;
-    ofstream file(fileName);
     while (p_dataSize--) {
         int ref = 0;
         while (ref < 1 || ref > referenceSize) { ref = referenceDst(generator); }
         const int dirtyBit = probabilityDst(generator) <= dirtyRate ? 1 : 0;
-        file << ref << " " << dirtyBit << endl;
+        referenceString.emplace_back(ref, dirtyBit);
     }
-    file.close();
+
+    GenerateStringFile(referenceString, fileName);
 }
 
 void ReferenceStringGenerator::ExponentialRandom(const double lambda, const string& fileName) {
+    ostringstream parameters;
+    parameters << setprecision(17) << "ExponentialRandom " << lambda;
+    if (ReuseStringFile(fileName, parameters.str())) { return; }
+
     exponential_distribution<double> referenceDst(lambda);
 
+    vector<pair<int, int>> referenceString;
     int p_dataSize = dataSize;
-    ofstream file(fileName);
     while (p_dataSize--) {
         int ref = 0;
         while (ref < 1 || ref > referenceSize) {
             ref = static_cast<int>(referenceDst(generator));
         }
         const int dirtyBit = probabilityDst(generator) <= dirtyRate ? 1 : 0;
-        file << ref << " " << dirtyBit << endl;
+        referenceString.emplace_back(ref, dirtyBit);
     }
-    file.close();
+
+    GenerateStringFile(referenceString, fileName);
+}
+
+bool ReferenceStringGenerator::ReuseStringFile(const string &fileName, const string &parameters) {
+    ostringstream full;
+    full << setprecision(17) << parameters << " dataSize=" << dataSize << " referenceSize=" << referenceSize
+         << " dirtyRate=" << dirtyRate << " seed=" << seed;
+    description = full.str();
+
+    // The parameters of a generated file are kept next to it in "<fileName>.meta".
+    ifstream data(fileName), meta(fileName + ".meta");
+    string line;
+    if (data && getline(meta, line) && line == description) { return true; }
+
+    // Each reference string gets its own stream of random numbers,
+    // so reusing one file doesn't change the content of the others.
+    const uint64_t hash = Fnv1a(description.data(), description.size());
+    seed_seq sequence{seed, static_cast<unsigned int>(hash), static_cast<unsigned int>(hash >> 32)};
+    generator.seed(sequence);
+    return false;
 }
 
-void ReferenceStringGenerator::GenerateStringFile(vector<pair<int, int>> referenceString, const string &fileName) {
-    // Write the reference string and dirty bit to the output file.
-    ofstream file(fileName);
-    for (const auto& entry : referenceString)
-        file << entry.first << " " << entry.second << std::endl;
-    file.close();
+void ReferenceStringGenerator::GenerateStringFile(const vector<pair<int, int>> &referenceString, const string &fileName) {
+    // The old ".meta" goes first and the data is written to a temporary file, so an interrupted
+    // generation never leaves a partly written file that matches some parameters.
+    remove((fileName + ".meta").c_str());
+    const string temporaryFile = fileName + ".tmp";
+    if (HasSuffix(fileName, ".rlt")) {
+        // Write a run-length compressed reference string.
+        RunLengthWriter writer(temporaryFile);
+        for (const auto& entry : referenceString)
+            writer.Append(entry.first, entry.second);
+        writer.Close();
+    } else {
+        // Write the reference string and dirty bit to the output file.
+        ofstream file(temporaryFile);
+        for (const auto& entry : referenceString)
+            file << entry.first << " " << entry.second << "\n";
+        file.close();
+    }
+    if (rename(temporaryFile.c_str(), fileName.c_str()) != 0) { cerr << "Failed to write file: " << fileName << endl; return; }
+
+    ofstream meta(fileName + ".meta");
+    meta << description << endl;
+    meta.close();
 }
\ No newline at end of file
@@ -3,14 +3,17 @@
 
 #include <vector>
 #include <random>
+#include <string>
 
 using namespace std;
 
 class ReferenceStringGenerator {
 public:
+    // The same seed and parameters always generate the same reference string.
     ReferenceStringGenerator(const int p_dataSize = 200000, 
                         const int p_referenceSize = 1000, 
-                        const double p_dirtyRate = 0.5);
+                        const double p_dirtyRate = 0.5,
+                        const unsigned int p_seed = random_device{}());
     ~ReferenceStringGenerator() {}
     void UniformRandom(const int p_referenceRange = 20, const string &fileName = "uniform_reference_string.txt");
     void LocalityUniformRandom(const int p_referenceRange, const double subsetRateA = 1.0 / 30.0, const double subsetRateB = 1.0 / 20.0, const string &fileName = "locality_reference_string.txt");
@@ -22,13 +25,17 @@ private:
     int dataSize; // Number of memory references: At least 200,000 times
     double dirtyRate; // You can use both reference and dirty bits.
     int referenceRange; // Arbitrarily pick [1, 20] continuous numbers for each reference.
+    unsigned int seed;
+    string description; // Generator and parameters of the reference string being generated
     
-    random_device rd; 
     mt19937 generator; // pseudorandom number generator
     uniform_int_distribution<int> referenceDst;
     uniform_real_distribution<double> probabilityDst;
 
-    void GenerateStringFile(vector<pair<int, int>> referenceString, const string &fileName);
+    // Reuse an existing file generated with the same seed and parameters, otherwise reseed for a new one.
+    bool ReuseStringFile(const string &fileName, const string &parameters);
+    // A file name ending with ".rlt" is written as a run-length compressed reference string.
+    void GenerateStringFile(const vector<pair<int, int>> &referenceString, const string &fileName);
 };
 
 #endif // __referenceString__
\ No newline at end of file
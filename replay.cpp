@@ -0,0 +1,88 @@
+#include "bufferPool/bufferPool.hpp"
+#include "pageReplacement/pageReplacement.hpp"
+#include "performanceReport/performanceReport.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+using namespace std;
+
+// Replay reference strings against a concurrent buffer pool with 1 to N threads.
+// The reference strings are concatenated (each in its own page range) and split into one contiguous part per thread.
+// -s sets the number of CLOCK shards or LRU stripes (default 16); one shard evicts exactly like Second Chance.
+// ./replay <clock|lru> <frames> <max threads> [-s <shards>] <reference string> ...
+int main(int argc, const char * argv[]) {
+    int first = 4; // The first reference string
+    int shards = 16;
+    if (argc > 5 && string(argv[4]) == "-s") {
+        shards = stoi(argv[5]);
+        first = 6;
+    }
+    if (argc <= first) {
+        cerr << "Usage: " << argv[0] << " <clock|lru> <frames> <max threads> [-s <shards>] <reference string> ..." << endl;
+        return 1;
+    }
+    const string policy = argv[1];
+    const int memorySize = stoi(argv[2]);
+    const int maxThreads = stoi(argv[3]);
+    if (policy != "clock" && policy != "lru") {
+        cerr << "Unknown buffer pool: " << policy << " (clock or lru)" << endl;
+        return 1;
+    }
+
+    vector<Run> runs;
+    size_t references = 0;
+    for (int i = first; i < argc; ++i) {
+        PageReplacement pageReplacement(memorySize, argv[i]);
+        for (Run run : pageReplacement.getRuns()) {
+            run.pageNumber += PageNumber(i - first) << 40; // Keep the pages of every file apart
+            runs.push_back(run);
+        }
+        references += pageReplacement.getFileSize();
+    }
+    cout << "References: " << references << " (" << runs.size() << " runs), frames: " << memorySize
+         << ", " << (policy == "clock" ? "shards" : "stripes") << ": " << shards << endl;
+    cout << "threads  seconds  M refs/s  speedup  page faults  disk writes" << endl;
+
+    vector<int> threadCounts; // 1, 2, 4, ... and maxThreads
+    for (int threads = 1; threads < maxThreads; threads *= 2) { threadCounts.push_back(threads); }
+    threadCounts.push_back(max(1, maxThreads));
+
+    double baseline = 0;
+    for (const int threads : threadCounts) {
+        unique_ptr<BufferPool> pool;
+        if (policy == "clock") {
+            pool.reset(new ClockBufferPool(memorySize, shards));
+        } else {
+            pool.reset(new LruBufferPool(memorySize, shards));
+        }
+
+        auto worker = [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                // The rest of the run are hits to the same page.
+                pool->get(runs[i].pageNumber, runs[i].dirty);
+                for (int64_t j = 1; j < runs[i].count; ++j) { pool->get(runs[i].pageNumber); }
+            }
+        };
+        const auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back(worker, runs.size() * t / threads, runs.size() * (t + 1) / threads);
+        }
+        for (auto &w : workers) { w.join(); }
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (threads == 1) { baseline = seconds; }
+        const PerformanceReport performance = pool->getReport();
+        cout << setw(7) << threads << fixed << setprecision(3) << setw(9) << seconds
+             << setw(10) << references / seconds / 1e6 << setw(9) << baseline / seconds
+             << setw(13) << performance.pageFaults << setw(13) << performance.diskWrites << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "resultCache.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// Each line of the file: <key> \t <pageFaults> <interrupts> <diskWrites> [<repetitions> <mean seconds> <variance>]
+ResultCache::ResultCache(const string p_fileName) : fileName(p_fileName) {
+    ifstream file(fileName);
+    string line;
+    while (getline(file, line)) {
+        const size_t tab = line.find('\t');
+        if (tab == string::npos) { continue; }
+        PerformanceReport performance;
+        performance.reset();
+        istringstream counts(line.substr(tab + 1));
+        if (counts >> performance.pageFaults >> performance.interrupts >> performance.diskWrites) {
+            Timing timing;
+            if (!(counts >> timing.repetitions >> timing.mean >> timing.variance)) { timing = Timing(); } // Saved without timing
+            results[line.substr(0, tab)] = make_pair(performance, timing); // A later line replaces an earlier one
+        }
+    }
+    file.close();
+}
+
+bool ResultCache::find(const uint64_t traceHash, const string &algorithmName, const int version,
+                       const int memorySize, const double parameter, PerformanceReport &performance, Timing *timing) {
+    const string key = Key(traceHash, algorithmName, version, memorySize, parameter);
+    lock_guard<mutex> guard(lock);
+    auto it = results.find(key);
+    if (it == results.end()) { return false; }
+
+    performance = it->second.first;
+    if (timing) { *timing = it->second.second; }
+    performance.algorithmName = algorithmName;
+    performance.memorySize = memorySize;
+    return true;
+}
+
+void ResultCache::insert(const uint64_t traceHash, const int version, const int memorySize, const double parameter,
+                         const PerformanceReport &performance, const Timing &timing) {
+    const string key = Key(traceHash, performance.algorithmName, version, memorySize, parameter);
+    lock_guard<mutex> guard(lock);
+    results[key] = make_pair(performance, timing);
+
+    ofstream file(fileName, ios::app);
+    if (!file) { cerr << "Failed to open file. \n"; return; }
+    file << key << "\t" << performance.pageFaults << " " << performance.interrupts << " " << performance.diskWrites;
+    if (timing.repetitions > 0) { file << " " << timing.repetitions << " " << timing.mean << " " << timing.variance; }
+    file << "\n";
+    file.close();
+}
+
+string ResultCache::Key(const uint64_t traceHash, const string &algorithmName, const int version, const int memorySize, const double parameter) {
+    // An integer parameter keeps its old text, e.g. "20", so earlier results still match.
+    ostringstream key;
+    key << hex << traceHash << dec << ":" << memorySize << ":" << FormatParameter(parameter) << ":" << version << ":" << algorithmName;
+    return key.str();
+}
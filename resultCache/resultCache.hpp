@@ -0,0 +1,47 @@
+#ifndef __resultCache__
+#define __resultCache__
+
+#include "../performanceReport/performanceReport.hpp"
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <mutex>
+
+using namespace std;
+
+// 64-bit FNV-1a hash, stable across runs and platforms.
+inline uint64_t Fnv1a(const void *data, const size_t size, uint64_t hash = 14695981039346656037ULL) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) { hash = (hash ^ bytes[i]) * 1099511628211ULL; }
+    return hash;
+}
+
+typedef struct Timing { // Seconds per simulation, over the repetitions of an experiment cell
+    int repetitions = 0;
+    double mean = 0;
+    double variance = 0;
+} Timing;
+
+// Content-addressed store of simulation results.
+// A result is keyed by the hash of the reference string, the algorithm name and version,
+// and the parameters (number of frames, ARB interval, samples or alpha), so a changed trace or algorithm misses the cache.
+// find() and insert() may be called from several threads.
+class ResultCache {
+public:
+    ResultCache(const string p_fileName = "result_cache.txt");
+    ~ResultCache() {}
+
+    bool find(const uint64_t traceHash, const string &algorithmName, const int version,
+              const int memorySize, const double parameter, PerformanceReport &performance, Timing *timing = nullptr);
+    void insert(const uint64_t traceHash, const int version, const int memorySize, const double parameter,
+                const PerformanceReport &performance, const Timing &timing = Timing());
+
+private:
+    string fileName; // Every inserted result is appended to this file
+    unordered_map<string, pair<PerformanceReport, Timing>> results;
+    mutex lock; // Guards results and the appends to the file
+
+    string Key(const uint64_t traceHash, const string &algorithmName, const int version, const int memorySize, const double parameter);
+};
+
+#endif // __resultCache__
@@ -0,0 +1,138 @@
+#include "runLengthTrace.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+static const char magic[4] = {'R', 'L', 'T', '1'};
+
+// Record header (varint):
+//   repeat:   (count << 2) | (dirty << 1) | 0, then the page delta
+//   sequence: (length << 1) | 1, then the page delta and ceil(length / 8) bytes of dirty bits
+RunLengthWriter::RunLengthWriter(const string &fileName)
+    : file(fileName, ios::binary), previous(0), current({0, 0, 0}), sequenceHead(0) {
+        if (!file) { cerr << "File don't be opened: " << fileName << endl; }
+        file.write(magic, sizeof(magic));
+    }
+
+void RunLengthWriter::Append(const PageNumber pageNumber, const int dirty) {
+    // Back-to-back repeats of the same page collapse into one run.
+    if (current.count > 0 && current.pageNumber == pageNumber) {
+        ++current.count;
+        current.dirty |= dirty;
+        return;
+    }
+    if (current.count > 0) { FlushRun(current); }
+    current = {pageNumber, dirty, 1};
+}
+
+void RunLengthWriter::Close() {
+    if (!file.is_open()) { return; }
+    if (current.count > 0) { FlushRun(current); }
+    FlushSequence();
+    current.count = 0;
+    file.close();
+}
+
+void RunLengthWriter::FlushRun(const Run &run) {
+    // Extend the sequence if the run is a single reference to the next page.
+    if (run.count == 1 && !sequence.empty() && run.pageNumber == sequenceHead + (PageNumber)sequence.size()) {
+        sequence.push_back(run.dirty);
+        return;
+    }
+    FlushSequence();
+    if (run.count == 1) {
+        sequenceHead = run.pageNumber;
+        sequence.push_back(run.dirty);
+    } else {
+        WriteRecord((uint64_t(run.count) << 2) | (uint64_t(run.dirty) << 1), run.pageNumber);
+        previous = run.pageNumber;
+    }
+}
+
+void RunLengthWriter::FlushSequence() {
+    if (sequence.empty()) { return; }
+    if (sequence.size() == 1) {
+        WriteRecord((uint64_t(1) << 2) | (uint64_t(sequence[0]) << 1), sequenceHead);
+    } else {
+        WriteRecord((uint64_t(sequence.size()) << 1) | 1, sequenceHead);
+        for (size_t i = 0; i < sequence.size(); i += 8) {
+            unsigned char bits = 0;
+            for (size_t j = i; j < min(i + 8, sequence.size()); ++j) { bits |= sequence[j] << (j - i); }
+            file.put(bits);
+        }
+    }
+    previous = sequenceHead + sequence.size() - 1;
+    sequence.clear();
+}
+
+void RunLengthWriter::WriteRecord(const uint64_t header, const PageNumber pageNumber) {
+    WriteVarint(header);
+    const int64_t delta = pageNumber - previous;
+    WriteVarint((uint64_t(delta) << 1) ^ uint64_t(delta >> 63)); // zigzag
+}
+
+void RunLengthWriter::WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+        file.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    file.put(static_cast<char>(value));
+}
+
+static bool ReadVarint(istream &file, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int c = file.get();
+        if (c == EOF) { return false; }
+        value |= uint64_t(c & 0x7f) << shift;
+        if ((c & 0x80) == 0) { return true; }
+    }
+    return false;
+}
+
+bool IsRunLengthTrace(const string &fileName) {
+    ifstream file(fileName, ios::binary);
+    char header[4];
+    return file.read(header, sizeof(header)) && equal(header, header + 4, magic);
+}
+
+bool ReadRunLengthTrace(const string &fileName, vector<Run> &runs) {
+    ifstream file(fileName, ios::binary);
+    char header[4];
+    if (!file.read(header, sizeof(header)) || !equal(header, header + 4, magic)) {
+        cerr << "Not a run-length trace: " << fileName << endl;
+        return false;
+    }
+
+    PageNumber previous = 0;
+    uint64_t recordHeader, zigzag;
+    while (ReadVarint(file, recordHeader)) {
+        if (!ReadVarint(file, zigzag)) { cerr << "Truncated run-length trace: " << fileName << endl; return false; }
+        const PageNumber pageNumber = previous + static_cast<int64_t>((zigzag >> 1) ^ (0 - (zigzag & 1)));
+
+        if ((recordHeader & 1) == 0) {
+            AppendRun(runs, {pageNumber, static_cast<int>((recordHeader >> 1) & 1), static_cast<int64_t>(recordHeader >> 2)});
+            previous = pageNumber;
+        } else {
+            const uint64_t length = recordHeader >> 1;
+            for (uint64_t i = 0; i < length; i += 8) {
+                const int bits = file.get();
+                if (bits == EOF) { cerr << "Truncated run-length trace: " << fileName << endl; return false; }
+                for (uint64_t j = i; j < min(i + 8, length); ++j) {
+                    AppendRun(runs, {pageNumber + (PageNumber)j, (bits >> (j - i)) & 1, 1});
+                }
+            }
+            previous = pageNumber + length - 1;
+        }
+    }
+
+    return true;
+}
+
+bool HasSuffix(const string &fileName, const string &suffix) {
+    return fileName.size() >= suffix.size() && fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
@@ -0,0 +1,40 @@
+#ifndef __runLengthTrace__
+#define __runLengthTrace__
+
+#include "../pageReplacement/pageReplacement.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+
+using namespace std;
+
+// Run-length compressed reference string (".rlt" files).
+// Back-to-back repeats of a page collapse into one record whose dirty bit is the OR of the repeats,
+// and sequential pages (p, p+1, p+2, ...) are stored as one record with a packed dirty bitmap.
+// Page numbers are stored as zigzag varint deltas from the last page of the previous record.
+class RunLengthWriter {
+public:
+    RunLengthWriter(const string &fileName);
+    ~RunLengthWriter() { Close(); }
+
+    void Append(const PageNumber pageNumber, const int dirty);
+    void Close();
+
+private:
+    ofstream file;
+    PageNumber previous; // Last page of the previous record
+    Run current; // The run being collapsed
+    PageNumber sequenceHead; // First page of the sequence being built
+    vector<int> sequence; // Dirty bits of the sequence being built
+
+    void FlushRun(const Run &run);
+    void FlushSequence();
+    void WriteRecord(const uint64_t header, const PageNumber pageNumber);
+    void WriteVarint(uint64_t value);
+};
+
+bool IsRunLengthTrace(const string &fileName); // Check the magic number of a file
+bool ReadRunLengthTrace(const string &fileName, vector<Run> &runs); // Decode a file into runs
+bool HasSuffix(const string &fileName, const string &suffix);
+
+#endif // __runLengthTrace__
@@ -0,0 +1,165 @@
+#include "traceImporter.hpp"
+#include "../runLengthTrace/runLengthTrace.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+static const size_t streamBufferSize = 1 << 20; // Read and write the traces in 1 MiB blocks
+
+int PageShift(const uint64_t pageSize) {
+    // A page size must be a power of two, e.g. 4K, 2M (huge page) or 1G.
+    if (pageSize == 0 || (pageSize & (pageSize - 1)) != 0) { return -1; }
+    int shift = 0;
+    while ((uint64_t(1) << shift) < pageSize) { ++shift; }
+    return shift;
+}
+
+TraceImporter::TraceImporter(const uint64_t p_pageSize) : pageSize(4096), pageShift(12) {
+    setPageSize(p_pageSize);
+}
+
+bool TraceImporter::setPageSize(const uint64_t p_pageSize) {
+    const int shift = PageShift(p_pageSize);
+    if (shift < 0) {
+        cerr << "Page size must be a power of two: " << p_pageSize << endl;
+        return false;
+    }
+    pageSize = p_pageSize;
+    pageShift = shift;
+    return true;
+}
+
+uint64_t TraceImporter::ImportLackey(const string &traceName, const string &fileName) {
+    return Import(traceName, fileName, false);
+}
+
+uint64_t TraceImporter::ImportBinary(const string &traceName, const string &fileName) {
+    return Import(traceName, fileName, true);
+}
+
+uint64_t TraceImporter::Import(const string &traceName, const string &fileName, const bool binary) {
+    // A file name ending with ".rlt" is written as a run-length compressed reference string.
+    unique_ptr<RunLengthWriter> writer;
+    vector<char> outBuffer(streamBufferSize);
+    ofstream file;
+    if (HasSuffix(fileName, ".rlt")) {
+        writer.reset(new RunLengthWriter(fileName));
+    } else {
+        file.rdbuf()->pubsetbuf(outBuffer.data(), outBuffer.size());
+        file.open(fileName);
+    }
+
+    uint64_t references = 0;
+    auto access = [&](uint64_t address, uint64_t size, int dirty) {
+        // An access that straddles a page boundary references every page it touches.
+        const uint64_t firstPage = address >> pageShift;
+        const uint64_t lastPage = (address + (size == 0 ? 0 : size - 1)) >> pageShift;
+        for (uint64_t page = firstPage; page <= lastPage; ++page) {
+            if (writer) {
+                writer->Append(static_cast<PageNumber>(page), dirty);
+            } else {
+                file << page << " " << dirty << "\n";
+            }
+        }
+        references += lastPage - firstPage + 1;
+    };
+    if (binary) {
+        DecodeBinary(traceName, access);
+    } else {
+        DecodeLackey(traceName, access);
+    }
+
+    if (writer) { writer->Close(); } else { file.close(); }
+    return references;
+}
+
+vector<vector<Run>> TraceImporter::LoadMultiple(const string &format, const string &traceName, const vector<uint64_t> &pageSizes) {
+    vector<int> shifts;
+    for (const auto size : pageSizes) {
+        shifts.push_back(PageShift(size));
+        if (shifts.back() < 0) {
+            cerr << "Page size must be a power of two: " << size << endl;
+            return {};
+        }
+    }
+
+    // Every page size shares the same decoding pass over the trace.
+    vector<vector<Run>> referenceStrings(pageSizes.size());
+    auto access = [&](uint64_t address, uint64_t size, int dirty) {
+        const uint64_t last = address + (size == 0 ? 0 : size - 1);
+        for (int i = 0; i < shifts.size(); ++i) {
+            for (uint64_t page = address >> shifts[i]; page <= (last >> shifts[i]); ++page) {
+                AppendRun(referenceStrings[i], {static_cast<PageNumber>(page), dirty, 1});
+            }
+        }
+    };
+
+    bool decoded = false;
+    if (format == "lackey") {
+        decoded = DecodeLackey(traceName, access);
+    } else if (format == "binary") {
+        decoded = DecodeBinary(traceName, access);
+    } else {
+        cerr << "Unknown trace format: " << format << " (lackey or binary)" << endl;
+    }
+    if (!decoded) { return {}; }
+
+    return referenceStrings;
+}
+
+bool TraceImporter::DecodeLackey(const string &traceName, const function<void(uint64_t, uint64_t, int)> &access) {
+    vector<char> inBuffer(streamBufferSize);
+    ifstream trace;
+    trace.rdbuf()->pubsetbuf(inBuffer.data(), inBuffer.size());
+    trace.open(traceName);
+    if (!trace) { cerr << "Trace file don't be opened: " << traceName << endl; return false; }
+
+    string line;
+    while (getline(trace, line)) {
+        // Skip the leading spaces, then the first character is the access type.
+        size_t i = line.find_first_not_of(' ');
+        if (i == string::npos || i + 1 >= line.size()) { continue; }
+        const char type = line[i];
+        if (type != 'L' && type != 'S' && type != 'M') { continue; } // "I" and "==pid==" lines
+
+        // Format: <type> <hex address>,<size>
+        const size_t comma = line.find(',', i + 1);
+        if (comma == string::npos) { continue; }
+        uint64_t address, size;
+        try {
+            address = stoull(line.substr(i + 1, comma - i - 1), nullptr, 16);
+            size = stoull(line.substr(comma + 1));
+        } catch (const exception &) {
+            continue; // A truncated line at the end of a trace
+        }
+
+        // A store or a modify (load + store) sets the dirty bit.
+        access(address, size, type == 'L' ? 0 : 1);
+    }
+    trace.close();
+
+    return true;
+}
+
+bool TraceImporter::DecodeBinary(const string &traceName, const function<void(uint64_t, uint64_t, int)> &access) {
+    vector<char> inBuffer(streamBufferSize);
+    ifstream trace;
+    trace.rdbuf()->pubsetbuf(inBuffer.data(), inBuffer.size());
+    trace.open(traceName, ios::binary);
+    if (!trace) { cerr << "Trace file don't be opened: " << traceName << endl; return false; }
+
+    unsigned char record[9]; // 8-byte address + 1-byte is_write
+    while (trace.read(reinterpret_cast<char *>(record), sizeof(record))) {
+        uint64_t address = 0;
+        for (int i = 7; i >= 0; --i) { address = (address << 8) | record[i]; } // little-endian
+        access(address, 1, record[8] != 0 ? 1 : 0);
+    }
+    if (trace.gcount() != 0) { cerr << "Trace file ends with a partial record: " << traceName << endl; }
+    trace.close();
+
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef __traceImporter__
+#define __traceImporter__
+
+#include "../pageReplacement/pageReplacement.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <functional>
+
+using namespace std;
+
+// Convert real memory-access traces into the "page dirty" reference string format.
+// Addresses are mapped to pages with a configurable page size (4K/2M/1G).
+class TraceImporter {
+public:
+    TraceImporter(const uint64_t p_pageSize = 4096);
+    ~TraceImporter() {}
+
+    bool setPageSize(const uint64_t p_pageSize);
+    uint64_t getPageSize() { return pageSize; }
+
+    // Valgrind Lackey (--trace-mem=yes): " L addr,size", " S addr,size", " M addr,size".
+    // Instruction fetches ("I") are skipped. Returns the number of references written.
+    // A file name ending with ".rlt" is written as a run-length compressed reference string.
+    uint64_t ImportLackey(const string &traceName, const string &fileName = "imported_reference_string.txt");
+    // Raw binary records: 8-byte little-endian address followed by a 1-byte is_write flag.
+    uint64_t ImportBinary(const string &traceName, const string &fileName = "imported_reference_string.txt");
+
+    // Decode a "lackey" or "binary" trace once and map every access to pages of each page size.
+    // The i-th reference string belongs to pageSizes[i] and is collapsed into runs as it is decoded, so memory
+    // grows with the runs rather than the accesses; an empty result means the trace can't be read.
+    vector<vector<Run>> LoadMultiple(const string &format, const string &traceName, const vector<uint64_t> &pageSizes);
+
+private:
+    uint64_t pageSize; // Bytes per page, must be a power of two
+    int pageShift; // log2(pageSize), so a page number is (address >> pageShift)
+
+    // Stream the trace and call access(address, size, dirty) for every load, store and modify.
+    bool DecodeLackey(const string &traceName, const function<void(uint64_t, uint64_t, int)> &access);
+    bool DecodeBinary(const string &traceName, const function<void(uint64_t, uint64_t, int)> &access);
+    uint64_t Import(const string &traceName, const string &fileName, const bool binary);
+};
+
+int PageShift(const uint64_t pageSize); // log2 of a power-of-two page size, -1 otherwise
+
+#endif // __traceImporter__